@@ -1,5 +1,6 @@
 QT       += core gui xml
 QT       += printsupport
+QT       += concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -20,6 +21,11 @@ DEFINES += TEST
 
 QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
 
+# inflate of the PBF blobs and of .osm.gz
+LIBS += -lz
+# .osm.bz2
+LIBS += -lbz2
+
 INCLUDEPATH += ./geo
 INCLUDEPATH += ./osm
 INCLUDEPATH += ./trafalgar
@@ -35,9 +41,20 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     osm/tr_import_osm.cpp \
+    osm/tr_import_osm_o5m.cpp \
+    osm/tr_import_osm_pbf.cpp \
     osm/tr_import_osm_rel.cpp \
     osm/tr_import_osm_stream.cpp \
+    osm/tr_osm_cache.cpp \
+    osm/tr_osm_clip.cpp \
+    osm/tr_osm_id_set.cpp \
+    osm/tr_osm_inflate.cpp \
     osm/tr_osm_link.cpp \
+    osm/tr_osm_name_dict.cpp \
+    osm/tr_osm_node_index.cpp \
+    osm/tr_osm_ring.cpp \
+    osm/tr_osm_tag_pool.cpp \
+    osm/tr_osm_xml_scan.cpp \
     profile.cpp \
     profiledialog.cpp \
     tr_canvas.cpp \
@@ -57,6 +74,7 @@ SOURCES += \
     trafalgar/tr_map_net.cpp \
     trafalgar/tr_map_net_road.cpp \
     trafalgar/tr_map_node.cpp \
+    trafalgar/tr_map_node_pool.cpp \
     trafalgar/tr_map_poi.cpp \
     trafalgar/tr_name_element.cpp \
     trafalgar/tr_stack.cpp \
@@ -75,13 +93,28 @@ HEADERS += \
     geo/geo_poly.h \
     geo/geo_ref.h \
     mainwindow.h \
+    osm/osm_block.h \
     osm/osm_load.h \
     osm/osm_load_rel.h \
+    osm/osm_num.h \
+    osm/osm_tag_hash.h \
     osm/osm_types.h \
+    osm/osm_view.h \
     osm/tr_import_osm.h \
+    osm/tr_import_osm_o5m.h \
+    osm/tr_import_osm_pbf.h \
     osm/tr_import_osm_rel.h \
     osm/tr_import_osm_stream.h \
+    osm/tr_osm_cache.h \
+    osm/tr_osm_clip.h \
+    osm/tr_osm_id_set.h \
+    osm/tr_osm_inflate.h \
     osm/tr_osm_link.h \
+    osm/tr_osm_name_dict.h \
+    osm/tr_osm_node_index.h \
+    osm/tr_osm_ring.h \
+    osm/tr_osm_tag_pool.h \
+    osm/tr_osm_xml_scan.h \
     profile.h \
     profiledialog.h \
     tr_canvas.h \
@@ -102,6 +135,7 @@ HEADERS += \
     trafalgar/tr_map_net.h \
     trafalgar/tr_map_net_road.h \
     trafalgar/tr_map_node.h \
+    trafalgar/tr_map_node_pool.h \
     trafalgar/tr_map_poi.h \
     trafalgar/tr_name_element.h \
     trafalgar/tr_point.h \
@@ -24,12 +24,19 @@
 #include "ui_fileoptions.h"
 
 #include <tr_defs.h>
+#include <tr_import_osm.h>
+#include <tr_osm_clip.h>
 
 #include <QFileDialog>
+#include <QRectF>
+
+// import flags of the check boxes
+#define FILE_OPTIONS_MODE_DIALOG    (TR_IMPORT_MAPPED | TR_IMPORT_PARALLEL | TR_IMPORT_CACHE)
 
 FileOptions::FileOptions(QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::FileOptions)
+    ui(new Ui::FileOptions),
+    m_import_mode(0)
 {
     ui->setupUi(this);
 }
@@ -44,6 +51,36 @@ QString FileOptions::getOsmDir()
     return ui->osmDir->text();
 }
 
+uint64_t FileOptions::getImportMode()
+{
+    uint64_t mode = m_import_mode & (~FILE_OPTIONS_MODE_DIALOG);
+    if(ui->mappedCheck->checkState() == Qt::Checked)
+        mode |= TR_IMPORT_MAPPED;
+    if(ui->parallelCheck->checkState() == Qt::Checked)
+        mode |= TR_IMPORT_PARALLEL;
+    if(ui->cacheCheck->checkState() == Qt::Checked)
+        mode |= TR_IMPORT_CACHE;
+    return mode;
+}
+
+bool FileOptions::getClip(TrOsmClip & clip)
+{
+    clip.clear();
+    if(!ui->regionBox->isChecked())
+        return false;
+    if(!ui->polyFile->text().isEmpty())
+        return clip.readPoly(ui->polyFile->text());
+
+    TrPoint clip_min;
+    TrPoint clip_max;
+    clip_min.x = ui->westSpin->value() * TR_COOR_FACTOR;
+    clip_min.y = ui->southSpin->value() * TR_COOR_FACTOR;
+    clip_max.x = ui->eastSpin->value() * TR_COOR_FACTOR;
+    clip_max.y = ui->northSpin->value() * TR_COOR_FACTOR;
+    clip.setRect(clip_min, clip_max);
+    return true;
+}
+
 bool FileOptions::getShiftOption()
 {
     return (ui->shiftCheck->checkState() == Qt::Checked);
@@ -72,6 +109,16 @@ void FileOptions::on_setProfileDir_clicked()
     ui->profileDir->insert(fileName);
 }
 
+void FileOptions::on_setPolyFile_clicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Region"),
+                                         ui->polyFile->text(), tr("Polygon File (*.poly)"));
+    if(fileName.isEmpty())
+        return;
+    ui->polyFile->clear();
+    ui->polyFile->insert(fileName);
+}
+
 void FileOptions::manageSettings(QSettings & settings, bool mode)
 {
     settings.beginGroup("Files");
@@ -87,6 +134,39 @@ void FileOptions::manageSettings(QSettings & settings, bool mode)
         {
             ui->shiftCheck->setCheckState(Qt::Unchecked);
         }
+        // not set: the default of the dialog
+        if(settings.contains("Mapped"))
+        {
+            if(settings.value("Mapped").toInt())
+                ui->mappedCheck->setCheckState(Qt::Checked);
+            else
+                ui->mappedCheck->setCheckState(Qt::Unchecked);
+        }
+        if(settings.contains("Parallel"))
+        {
+            if(settings.value("Parallel").toInt())
+                ui->parallelCheck->setCheckState(Qt::Checked);
+            else
+                ui->parallelCheck->setCheckState(Qt::Unchecked);
+        }
+        if(settings.value("Cache").toInt())
+        {
+            ui->cacheCheck->setCheckState(Qt::Checked);
+        }
+        else
+        {
+            ui->cacheCheck->setCheckState(Qt::Unchecked);
+        }
+        // the other flags, without a dialog entry
+        m_import_mode = settings.value("ImportMode", 0).toULongLong() & (~FILE_OPTIONS_MODE_DIALOG);
+        ui->regionBox->setChecked(settings.value("Region").toInt() != 0);
+        // degree, left: west, top: south
+        QRectF rect = settings.value("RegionRect").toRectF();
+        ui->westSpin->setValue(rect.left());
+        ui->southSpin->setValue(rect.top());
+        ui->eastSpin->setValue(rect.right());
+        ui->northSpin->setValue(rect.bottom());
+        ui->polyFile->setText(settings.value("RegionPoly").toString());
     }
     else            // write
     {
@@ -101,6 +181,35 @@ void FileOptions::manageSettings(QSettings & settings, bool mode)
         {
             settings.setValue("Shift", 0);
         }
+        if(ui->mappedCheck->checkState() == Qt::Checked)
+        {
+            settings.setValue("Mapped", 2);
+        }
+        else
+        {
+            settings.setValue("Mapped", 0);
+        }
+        if(ui->parallelCheck->checkState() == Qt::Checked)
+        {
+            settings.setValue("Parallel", 2);
+        }
+        else
+        {
+            settings.setValue("Parallel", 0);
+        }
+        if(ui->cacheCheck->checkState() == Qt::Checked)
+        {
+            settings.setValue("Cache", 2);
+        }
+        else
+        {
+            settings.setValue("Cache", 0);
+        }
+        settings.setValue("ImportMode", static_cast<qulonglong>(m_import_mode));
+        settings.setValue("Region", ui->regionBox->isChecked() ? 2 : 0);
+        settings.setValue("RegionRect", QRectF(QPointF(ui->westSpin->value(), ui->southSpin->value()),
+                                               QPointF(ui->eastSpin->value(), ui->northSpin->value())));
+        settings.setValue("RegionPoly", ui->polyFile->text());
     }
     settings.endGroup();
 }
@@ -26,6 +26,8 @@
 #include <QDialog>
 #include <QSettings>
 
+class TrOsmClip;
+
 namespace Ui {
 class FileOptions;
 }
@@ -41,6 +43,9 @@ public:
     QString getOsmDir();
     QString getProfileFileName();
     bool getShiftOption();
+    uint64_t getImportMode();
+    // region of the import, false and not valid: the whole file
+    bool getClip(TrOsmClip & clip);
 
     void manageSettings(QSettings &settings, bool mode);
 
@@ -49,8 +54,13 @@ private slots:
 
     void on_setProfileDir_clicked();
 
+    void on_setPolyFile_clicked();
+
 private:
     Ui::FileOptions *ui;
-};
+
+    // flags for TrImportOsm::setImportMode without a check box
+    // ('ImportMode' setting), the dialog sets the reader and the cache
+    uint64_t m_import_mode;};
 
 #endif // FILEOPTIONS_H
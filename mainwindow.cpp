@@ -93,34 +93,46 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
-void MainWindow::createRoadNetObjects(const QStringList & list, TrImportOsm & filter)
+void MainWindow::createNetObjects(const QStringList & road_list, const QStringList & list, TrImportOsm & filter)
 {
-    for(int i = 0; i < list.size(); i++)
-    {
-        TrMapNet * road_net = new TrMapNetRoad();
-        filter.createNet(road_net, list[i]);
-        m_map_view->getDocument().addMapLayerObjectByName(list[i], road_net);
-    }
-}
+    QVector<TrMapNet *> nets;
+    QStringList names = road_list + list;
 
-void MainWindow::createNetObjects(const QStringList & list, TrImportOsm & filter)
-{
+    for(int i = 0; i < road_list.size(); i++)
+        nets.append(new TrMapNetRoad());
     for(int i = 0; i < list.size(); i++)
+        nets.append(new TrMapNet());
+
+    // the nets are built on worker threads, the document is changed here
+    QVector<bool> net_ok;
+    filter.createNets(nets, names, net_ok);
+    for(int i = 0; i < nets.size(); i++)
     {
-        TrMapNet * net = new TrMapNet();
-        filter.createNet(net, list[i]);
-        m_map_view->getDocument().addMapLayerObjectByName(list[i], net);
+        if(net_ok[i])
+            m_map_view->getDocument().addMapLayerObjectByName(names[i], nets[i]);
+        else
+        {
+            // a net which failed is not added half built
+            TR_ERR << "net" << names[i] << "skipped";
+            delete nets[i];
+        }
     }
 }
 
 void MainWindow::createFaceObjects(const QStringList & list, TrImportOsm & filter)
 {
+    QVector<TrMapList *> face_lists;
     for(int i = 0; i < list.size(); i++)
+        face_lists.append(new TrMapList());
+
+    // all layers in one pass over the ways
+    if(filter.createFaceLists(face_lists, list))
     {
-        TrMapList * tr_list = new TrMapList();
-        if(filter.createFaceList(tr_list, list[i]))
-            m_map_view->getDocument().addMapLayerObjectByName(list[i], tr_list);
+        for(int i = 0; i < list.size(); i++)
+            m_map_view->getDocument().addMapLayerObjectByName(list[i], face_lists[i]);
     }
+    else
+        qDeleteAll(face_lists);
 }
 
 void MainWindow::writeSettings()
@@ -157,7 +169,7 @@ void MainWindow::on_actionOpen_triggered()
     }
     TR_INF << m_file_options->getOsmDir();
     QString fileName = QFileDialog::getOpenFileName(this, tr("Open OSM File"),
-              m_file_options->getOsmDir(), tr("OSM File (*.osm)"));
+              m_file_options->getOsmDir(), tr("OSM File (*.osm *.pbf *.o5m *.osm.gz *.osm.bz2)"));
     on_loadWorld(fileName, m_file_options->getShiftOption());
 }
 
@@ -292,13 +304,17 @@ void MainWindow::on_loadWorld(const QString & filename, int shift)
         TrGeoObject::s_mask |= TR_MASK_MOVE_LINE;
 
     TrImportOsm osm_filter;
-    if(osm_filter.read(filename, m_map_view->getDocument().getNameList()) == false)
+    osm_filter.setImportMode(m_file_options->getImportMode());
+    // only a region of the file, set in the file options
+    TrOsmClip clip;
+    m_file_options->getClip(clip);
+    if(osm_filter.read(filename, m_map_view->getDocument().getNameList(),
+                       clip.isValid() ? &clip : nullptr) == false)
         return;
 
     QStringList rlist = m_profile_dlg->getElemStringList("layer", "roadnet");
     QStringList llist = m_profile_dlg->getElemStringList("layer", "net");
-    createRoadNetObjects(rlist, osm_filter);
-    createNetObjects(llist, osm_filter);
+    createNetObjects(rlist, llist, osm_filter);
     QStringList flist = m_profile_dlg->getElemStringList("layer", "face");
     createFaceObjects(flist, osm_filter);
     m_map_view->getDocument().setFileName(filename);
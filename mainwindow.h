@@ -101,8 +101,7 @@ private:
 
     QFont m_font;
 
-    void createNetObjects(const QStringList &list, TrImportOsm &filter);
-    void createRoadNetObjects(const QStringList &list, TrImportOsm &filter);
+    void createNetObjects(const QStringList &road_list, const QStringList &list, TrImportOsm &filter);
     void createFaceObjects(const QStringList &list, TrImportOsm &filter);
 
     void writeSettings();
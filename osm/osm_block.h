@@ -0,0 +1,126 @@
+/******************************************************************
+ *
+ * @short	decoded elements of a file part
+ *
+ * project:	Trafalgar/View
+ *
+ * modul:	osm_block.h	header for the parallel read
+ * @version	0.2
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * beginning:	10.2026
+ *
+ * history:
+ */
+/******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * The GNU trafalgar package is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with the GNU plotutils package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSM_BLOCK_H
+#define OSM_BLOCK_H
+
+#include <stdint.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include "osm_view.h"
+
+// part of the mapped file, decoded by one worker thread
+typedef struct
+{
+	const char * data;
+	uint32_t size;
+	// size after inflate, 0 for raw data
+	uint32_t raw_size;
+}OsmChunk_t;
+
+typedef struct
+{
+	uint64_t id;
+	int32_t x;
+	int32_t y;
+	// index and count in OsmBlock::tags
+	uint32_t tag;
+	uint32_t n_tag;
+}OsmBlockNode_t;
+
+typedef struct
+{
+	uint64_t id;
+	uint32_t tag;
+	uint32_t n_tag;
+	// index and count in OsmBlock::refs
+	uint32_t ref;
+	uint32_t n_ref;
+}OsmBlockWay_t;
+
+typedef struct
+{
+	uint64_t id;
+	// index in OsmBlock::views
+	uint32_t role;
+	// 0: node, 1: way, 2: relation
+	uint32_t type;
+}OsmBlockMember_t;
+
+typedef struct
+{
+	uint64_t id;
+	uint32_t tag;
+	uint32_t n_tag;
+	// index and count in OsmBlock::members
+	uint32_t mem;
+	uint32_t n_mem;
+}OsmBlockRel_t;
+
+// decoded elements of one chunk, all ids and coordinates are absolute
+struct OsmBlock
+{
+	bool ok;
+	QString error;
+
+	// inflated data, the string views are pointing into it or into the file
+	QByteArray data;
+	QVector<OsmView_t> views;
+	// pool id of each view used as a key, see TrImportOsmStream::blockKey
+	QVector<uint32_t> keys;
+	// XML text, the views can have entities
+	bool xml;
+
+	QVector<OsmBlockNode_t> nodes;
+	QVector<OsmBlockWay_t> ways;
+	QVector<OsmBlockRel_t> rels;
+
+	// pairs of string index (key, value)
+	QVector<uint32_t> tags;
+	QVector<uint64_t> refs;
+	QVector<OsmBlockMember_t> members;
+
+	OsmBlock()
+		: ok(false)
+		, xml(false)
+	{
+	}
+};
+
+#endif // OSM_BLOCK_H
@@ -168,16 +168,12 @@
 
 // TODO: c version?
 #include <QMap>
+
+#include "tr_osm_name_dict.h"
 #ifdef TESTX
 #include <tr_map_list.h>
 #endif
 
-struct name_set
-{
-	uint64_t id;
-	uint32_t number;
-};
-
 typedef struct
 {
 	uint64_t osm_base_class;
@@ -196,8 +192,12 @@ typedef struct
 
 	Point_t * points;
 
-	// use point struct for nodes
-	Point_t * nodes;
+	// nodes in id order, the coordinates are on the same position
+	uint64_t * node_ids;
+	Coor_t * node_coor;
+	// the tagged nodes, only these are POIs
+	Poi_t * pois;
+	size_t poi_count;
 	Way_t * ways;
 
 	Rel_t * relations;
@@ -228,17 +228,14 @@ typedef struct
 
 	uint32_t way_is_inside_class_def;
 
-	// TODO: collect data of way: max number of ids in node
-	// TODO: replace '10000' with collected data or realloc
-	uint64_t tmp_id_buf[10000];
+	// node ids of all ways, see Way_t::nd_ofs
+	uint64_t * nd_refs;
+	size_t nd_ref_count;
 
 	RelMember_t * rel_id_buf;
 	char * act_name;
-	uint64_t act_name_idx;
-	// Map on string key and integer as value
-	QMap<QString, name_set> m_name_map;
-	// Map on node id and name
-	QMap<uint64_t, QString> m_point_name_map;
+	// names of the ways and POIs
+	TrOsmNameDict m_names;
 
 	// values of points
 	uint32_t altitude;
@@ -0,0 +1,150 @@
+/******************************************************************
+ *
+ * @short	number parser for raw reading
+ *
+ * project:	Trafalgar/View
+ *
+ * modul:	osm_num.h	header for XML read
+ * @version	0.2
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * beginning:	10.2026
+ *
+ * history:
+ */
+/******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * The GNU trafalgar package is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with the GNU plotutils package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSM_NUM_H
+#define OSM_NUM_H
+
+#include <stdint.h>
+
+#include <QtCore/qstring.h>
+
+// fixed point format of Point_t: degree * (TR_COOR_FACTOR * 100.0)
+// OSM is using 7 decimal places, so the values are exact
+#define OSM_COOR_DIGITS 7
+#define OSM_COOR_SCALE  10000000
+
+// The parsers are working on 'char' (mapped file, UTF-8) and on
+// 'ushort' (UTF-16 of QStringRef) without any copy of the text.
+
+template <typename C>
+inline uint32_t osmDigit(C c)
+{
+	return static_cast<uint32_t>(c) - static_cast<uint32_t>('0');
+}
+
+// "1234567" -> 1234567; false on empty text, other characters or overflow
+template <typename C>
+inline bool osmParseId(const C * str, int len, uint64_t & val)
+{
+	uint64_t ret = 0;
+
+	val = 0;
+	if((str == nullptr) || (len <= 0) || (len > 20))
+		return false;
+	for(int i = 0; i < len; i++)
+	{
+		uint32_t d = osmDigit(str[i]);
+		if(d > 9)
+			return false;
+		if(ret > ((UINT64_MAX - d) / 10))
+			return false;
+		ret = ret * 10 + d;
+	}
+	val = ret;
+	return true;
+}
+
+// "-11.5033312" -> -115033312; more than 7 decimal places are rounded
+template <typename C>
+inline bool osmParseCoor(const C * str, int len, int32_t & val)
+{
+	int i = 0;
+	bool neg = false;
+	int64_t ret = 0;
+	int n_int = 0;
+	int n_frac = 0;
+
+	val = 0;
+	if((str == nullptr) || (len <= 0))
+		return false;
+
+	if((str[0] == '-') || (str[0] == '+'))
+	{
+		neg = (str[0] == '-');
+		i++;
+	}
+	for(; i < len; i++)
+	{
+		uint32_t d = osmDigit(str[i]);
+		if(d > 9)
+			break;
+		// no valid degree value has more than 3 digits
+		if(++n_int > 3)
+			return false;
+		ret = ret * 10 + d;
+	}
+	if((i < len) && (str[i] == '.'))
+	{
+		i++;
+		for(; i < len; i++)
+		{
+			uint32_t d = osmDigit(str[i]);
+			if(d > 9)
+				return false;
+			if(n_frac < OSM_COOR_DIGITS)
+			{
+				ret = ret * 10 + d;
+			}
+			else if(n_frac == OSM_COOR_DIGITS)
+			{
+				// round half away from zero
+				if(d >= 5)
+					ret++;
+			}
+			n_frac++;
+		}
+	}
+	if((i != len) || ((n_int + n_frac) == 0))
+		return false;
+	for(; n_frac < OSM_COOR_DIGITS; n_frac++)
+		ret *= 10;
+	if(ret > 1800000000)
+		return false;
+	val = static_cast<int32_t>(neg ? -ret : ret);
+	return true;
+}
+
+inline bool osmParseId(const QStringRef & ref, uint64_t & val)
+{
+	return osmParseId(reinterpret_cast<const ushort *>(ref.unicode()), ref.size(), val);
+}
+
+inline bool osmParseCoor(const QStringRef & ref, int32_t & val)
+{
+	return osmParseCoor(reinterpret_cast<const ushort *>(ref.unicode()), ref.size(), val);
+}
+
+#endif // OSM_NUM_H
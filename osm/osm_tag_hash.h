@@ -0,0 +1,155 @@
+/******************************************************************
+ *
+ * @short	perfect hash tables for the tag values
+ *
+ * project:	Trafalgar/View
+ *
+ * modul:	osm_tag_hash.h	header for the tag classes
+ * @version	0.2
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * beginning:	10.2026
+ *
+ * history:
+ */
+/******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * The GNU trafalgar package is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with the GNU plotutils package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef OSM_TAG_HASH_H
+#define OSM_TAG_HASH_H
+
+#include <stdint.h>
+
+#include <QtCore/qstring.h>
+
+// The value lists of the get*Class functions are tables of OsmTagEntry.
+// The slot table is created by the compiler, a static_assert on
+// osmTagPerfect checks that every value has its own slot, so a lookup
+// is one hash, one probe and one compare. A new value which gives a
+// collision needs a new seed (or more slots).
+
+typedef struct
+{
+	const char * value;
+	uint64_t code;
+}OsmTagEntry;
+
+// FNV-1a, the seed is the start value
+constexpr uint32_t osmTagHash(const char * str, uint32_t hash)
+{
+	return (*str == '\0') ? hash :
+			osmTagHash(str + 1, (hash ^ static_cast<uint8_t>(*str)) * 16777619U);
+}
+
+// the low bits of FNV depend only on the low bits of the input
+constexpr uint32_t osmTagIndex(uint32_t hash, uint32_t mask)
+{
+	return (hash ^ (hash >> 15)) & mask;
+}
+
+// same hash on the UTF-16 text, false for a character outside of ASCII
+inline bool osmTagHash(const QString & str, uint32_t seed, uint32_t & hash)
+{
+	const ushort * c = str.utf16();
+	hash = seed;
+	for(int i = 0; i < str.size(); i++)
+	{
+		if(c[i] > 0x7f)
+			return false;
+		hash = (hash ^ c[i]) * 16777619U;
+	}
+	return true;
+}
+
+constexpr int osmTagSlot(const OsmTagEntry * entry, int n_entry, uint32_t seed,
+		uint32_t mask, uint32_t slot, int i)
+{
+	return (i == n_entry) ? -1 :
+			((osmTagIndex(osmTagHash(entry[i].value, seed), mask) == slot) ? i :
+					osmTagSlot(entry, n_entry, seed, mask, slot, i + 1));
+}
+
+constexpr bool osmTagUnique(const OsmTagEntry * entry, int n_entry, uint32_t seed,
+		uint32_t mask, int i, int j)
+{
+	return (j == n_entry) ? true :
+			((osmTagIndex(osmTagHash(entry[i].value, seed), mask) !=
+					osmTagIndex(osmTagHash(entry[j].value, seed), mask)) &&
+					osmTagUnique(entry, n_entry, seed, mask, i, j + 1));
+}
+
+// no two values in one slot
+constexpr bool osmTagPerfect(const OsmTagEntry * entry, int n_entry, uint32_t seed,
+		uint32_t mask, int i = 0)
+{
+	return (i == n_entry) ? true :
+			(osmTagUnique(entry, n_entry, seed, mask, i, i + 1) &&
+					osmTagPerfect(entry, n_entry, seed, mask, i + 1));
+}
+
+template <int... I> struct OsmTagSeq {};
+template <int N, int... I> struct OsmTagMakeSeq : OsmTagMakeSeq<N - 1, N - 1, I...> {};
+template <int... I> struct OsmTagMakeSeq<0, I...> { typedef OsmTagSeq<I...> type; };
+
+// entry index of each slot, -1 for an empty slot, so 127 entries at most
+#define OSM_TAG_MAX_ENTRY 127
+
+template <int N_SLOT>
+struct OsmTagSlots
+{
+	int8_t entry[N_SLOT];
+};
+
+template <int N_ENTRY, int... S>
+constexpr OsmTagSlots<sizeof...(S)> osmTagSlots(const OsmTagEntry (&entry)[N_ENTRY], uint32_t seed,
+		OsmTagSeq<S...>)
+{
+	static_assert(N_ENTRY <= OSM_TAG_MAX_ENTRY, "too many values for the int8_t slots");
+	return OsmTagSlots<sizeof...(S)>{{ static_cast<int8_t>(osmTagSlot(entry, N_ENTRY, seed,
+			sizeof...(S) - 1, S, 0))... }};
+}
+
+// 'code' is unchanged if the value is not in the table
+template <int N_ENTRY, int N_SLOT>
+inline bool osmTagFind(const OsmTagEntry (&entry)[N_ENTRY], const OsmTagSlots<N_SLOT> & slots,
+		uint32_t seed, const QString & value, uint64_t & code)
+{
+	uint32_t hash = 0;
+	if(!osmTagHash(value, seed, hash))
+		return false;
+	int i = slots.entry[osmTagIndex(hash, N_SLOT - 1)];
+	if((i < 0) || (value != QLatin1String(entry[i].value)))
+		return false;
+	code = entry[i].code;
+	return true;
+}
+
+// table 'name' of 'n_slot' slots (2^n), needs the array 'name'_tags
+#define OSM_TAG_TABLE(name, n_slot, seed) \
+	static_assert(osmTagPerfect(name##_tags, sizeof(name##_tags) / sizeof(OsmTagEntry), seed, n_slot - 1), \
+			"collision in " #name ", use a new seed"); \
+	static constexpr OsmTagSlots<n_slot> name##_slots = \
+			osmTagSlots(name##_tags, seed, OsmTagMakeSeq<n_slot>::type()); \
+	static constexpr uint32_t name##_seed = seed;
+
+#endif // OSM_TAG_HASH_H
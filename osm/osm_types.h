@@ -51,12 +51,33 @@ typedef struct
 	uint64_t pt_data;
 }Point_t;
 
+// coordinates of a node, the id is in a separate array
+typedef struct
+{
+	int32_t x;
+	int32_t y;
+}Coor_t;
+
+// a node with a POI type, see TrMapPoi
+typedef struct
+{
+	uint64_t id;
+	int32_t x;
+	int32_t y;
+	uint64_t pt_type;
+	uint64_t pt_data;
+	// id of World_t::m_names, 0: no name
+	uint64_t name_id;
+}Poi_t;
+
 typedef struct
 {
 	uint64_t id;
 	// TODO: combine id and name_id?
 	uint64_t name_id;
-	uint64_t * nd_id;
+	// the node ids are in one array for all ways (World_t::nd_refs),
+	// 'nd_ofs' is the position of the first id
+	uint64_t nd_ofs;
 	int n_nd_id;
 	uint64_t type;
 	// uint16_t type;
@@ -0,0 +1,75 @@
+/******************************************************************
+ *
+ * @short	non-owning text views for raw reading
+ *
+ * project:	Trafalgar/View
+ *
+ * modul:	osm_view.h	header for XML read
+ * @version	0.2
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * beginning:	10.2026
+ *
+ * history:
+ */
+/******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * The GNU trafalgar package is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with the GNU plotutils package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSM_VIEW_H
+#define OSM_VIEW_H
+
+#include <stdint.h>
+#include <string.h>
+
+// points into the mapped file (or a decoded block), the data is not copied
+// and is only valid as long as the source buffer is alive
+typedef struct
+{
+	const char * ptr;
+	int32_t len;
+}OsmView_t;
+
+inline OsmView_t osmView(const char * ptr, int32_t len)
+{
+	OsmView_t view;
+	view.ptr = ptr;
+	view.len = len;
+	return view;
+}
+
+inline bool osmViewIs(const OsmView_t & view, const char * str)
+{
+	size_t len = strlen(str);
+	if(static_cast<size_t>(view.len) != len)
+		return false;
+	return (memcmp(view.ptr, str, len) == 0);
+}
+
+inline bool osmViewStartsWith(const OsmView_t & view, const char * str)
+{
+	size_t len = strlen(str);
+	if(static_cast<size_t>(view.len) < len)
+		return false;
+	return (memcmp(view.ptr, str, len) == 0);
+}
+
+#endif // OSM_VIEW_H
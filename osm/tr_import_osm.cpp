@@ -43,62 +43,63 @@
 
 #include "tr_name_element.h"
 #include "tr_import_osm_stream.h"
+#include "tr_import_osm_pbf.h"
+#include "tr_import_osm_o5m.h"
+#include "tr_osm_cache.h"
+#include "tr_osm_inflate.h"
 
 #include "tr_defs.h"
 #include "tr_import_osm.h"
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qthread.h>
+#include <QtConcurrent/qtconcurrentmap.h>
 #include <QDebug>
 #include <tr_map_face.h>
 #include <tr_map_net.h>
 
-#ifndef OSM_C_FILTER
-int inline findNode(Point_t * nodes, int n_node, uint64_t idx)
-{
-        int pos1 = 0;
-        int pos2 = n_node-1;
-        int d;
-
-        uint64_t id = idx;
-
-        if((id > nodes[n_node-1].id) || (id < nodes[0].id))
-                return -1;
-
-        while(nodes[pos2].id != id)
-        {
-                if(nodes[pos1].id == id)
-                        return pos1;
-
-                d = ((pos2-pos1) >> 1);
-
-                if(d == 0)
-                        return -1;
-
-                if(id < nodes[pos1+d].id)
-                        pos2 -= d;
-                else
-                        pos1 += d;
-        }
-        return pos2;
-}
-#endif
 
 
 TrImportOsm::TrImportOsm()
-	: m_waySize(0)
+	: m_degree(nullptr)
+	, m_pool_slots(nullptr)
+	, m_waySize(0)
 	, m_ways(nullptr)
+	, m_nd_refs(nullptr)
 	, m_nodeSize(0)
-	, m_nodes(nullptr)
+	, m_node_ids(nullptr)
+	, m_node_coor(nullptr)
+	, m_pois(nullptr)
     , m_poi_map(nullptr)
+	, m_cache(nullptr)
+	, m_import_mode(0)
 {
 }
 
 TrImportOsm::~TrImportOsm()
 {
-	// TODO: delete data...
+	// the stores of World_t, each one is a single block
+	// or a part of the mapped cache
+	if((m_cache == nullptr) || (!m_cache->isMapped()))
+	{
+		free(m_node_ids);
+		free(m_node_coor);
+		free(m_pois);
+		free(m_ways);
+		free(m_nd_refs);
+	}
+	free(m_degree);
+	free(m_pool_slots);
+	delete m_cache;
+}
+
+void TrImportOsm::setImportMode(uint64_t mode)
+{
+	m_import_mode = mode;
 }
 
-uint16_t TrImportOsm::setTrainType(TrOsmLink * link, uint64_t ttype)
+uint16_t TrImportOsm::setTrainType(uint64_t ttype)
 {
 	if(ttype & FLAG_PLANNED)
 		return 7;
@@ -119,7 +120,7 @@ uint16_t TrImportOsm::setTrainType(TrOsmLink * link, uint64_t ttype)
 	return 7;
 }
 
-uint16_t TrImportOsm::setWaterType(TrOsmLink * link, uint64_t ttype)
+uint16_t TrImportOsm::setWaterType(uint64_t ttype)
 {
 	uint16_t type = ttype & 0x0000000000000f;
 	if(type == 0)
@@ -131,70 +132,136 @@ uint16_t TrImportOsm::setWaterType(TrOsmLink * link, uint64_t ttype)
 	return type;
 }
 
-void TrImportOsm::appendPoi(void * world, const Point_t & point)
+void TrImportOsm::appendPoi(const Poi_t & poi, const QString & name)
 {
-    World_t * osm2_world = static_cast<World_t *>(world);
-
-	if(point.pt_type)
+	if(poi.pt_type)
 	{
 		TrMapPoi * elem = new TrMapPoi;
 		TrPoint pt;
 		// TODO: check the factor '100.0'
-		pt.x = (point.x)/100.0;
-		pt.y = (point.y)/100.0;
+		pt.x = (poi.x)/100.0;
+		pt.y = (poi.y)/100.0;
 		elem->setPoint(pt);
-		elem->setPoiName(osm2_world->m_point_name_map[point.id]);
-		elem->setPoiTypeFlags(point.pt_type);
-		elem->setPoiNumData(point.pt_data);
+		elem->setPoiName(name);
+		elem->setPoiTypeFlags(poi.pt_type);
+		elem->setPoiNumData(poi.pt_data);
 
-		m_poi_map->appendObject(elem, point.id);
+		m_poi_map->appendObject(elem, poi.id);
 	}
 	else
 	{
-        //TR_MSG << "no type info" << point.id << " " <<
-        //	osm2_world->m_point_name_map[point.id].toLocal8Bit().constData();
+        //TR_MSG << "no type info" << poi.id << " " << name.toLocal8Bit().constData();
 	}
 }
 
 
-bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
+// all formats are using the element interface of TrImportOsmStream
+bool TrImportOsm::readFile(const QString & filename, TrImportOsmStream & ios, void * osm_world)
+{
+	World_t & world = *static_cast<World_t *>(osm_world);
+
+	if(filename.endsWith(".PBF", Qt::CaseInsensitive))
+	{
+		TrImportOsmPbf pbf(filename);
+		return pbf.osmRead(ios, world);
+	}
+	if(filename.endsWith(".O5M", Qt::CaseInsensitive))
+	{
+		TrImportOsmO5m o5m(filename);
+		return o5m.osmRead(ios, world);
+	}
+	// decompressed while reading, there is no file to split for TR_IMPORT_PARALLEL
+	if(TrOsmInflate::isCompressed(filename))
+		return (m_import_mode & TR_IMPORT_MAPPED) ? ios.osmReadMapped(world) : ios.osmRead(world);
+	if((m_import_mode & TR_IMPORT_MAPPED) && (m_import_mode & TR_IMPORT_PARALLEL))
+		return ios.osmReadParallel(world);
+	if(m_import_mode & TR_IMPORT_MAPPED)
+		return ios.osmReadMapped(world);
+	return ios.osmRead(world);
+}
+
+bool TrImportOsm::read(const QString & filename, TrMapList & name_list, const TrOsmClip * clip)
 {
 	World_t osm2_world;
     bool add_it = true;
-	TrPoint pt;
-
-    TrOsmLink * olink = nullptr;
+	OsmRawWay_t raw_way;
+	// time of the import stages
+	QElapsedTimer stage_timer;
 
 	emit valueChanged(3);
+	stage_timer.start();
 
 	// POI - Point Of Interest
 	m_poi_map = new TrMapList();
 	// set layer name
 	m_poi_map->setObjClass("poi");
 
-	if(filename.endsWith(".OSM", Qt::CaseInsensitive))
+	if(filename.endsWith(".OSM", Qt::CaseInsensitive) || filename.endsWith(".PBF", Qt::CaseInsensitive) ||
+			filename.endsWith(".O5M", Qt::CaseInsensitive) || filename.endsWith(".OSM.GZ", Qt::CaseInsensitive) ||
+			filename.endsWith(".OSM.BZ2", Qt::CaseInsensitive))
 	{
         TR_INF << "osm file: " << filename;
 
         TrImportOsmStream ios(filename);
-		ios.osmRead(osm2_world);
-		for (auto i = ios.getNodeMap().cbegin(), end = ios.getNodeMap().cend(); i != end; ++i)
+		bool read_ok = false;
+		// a clipped import is never cached
+		bool use_cache = (m_import_mode & TR_IMPORT_CACHE) && ((clip == nullptr) || (!clip->isValid()));
+		uint64_t cache_mode = m_import_mode & TR_IMPORT_TWO_PASS;
+		if(use_cache)
+		{
+			if(m_cache == nullptr)
+				m_cache = new TrOsmCache();
+			read_ok = m_cache->load(filename, cache_mode, osm2_world);
+		}
+		if(read_ok)
+		{
+			// the stream is not used
+		}
+		else if((clip != nullptr) && clip->isValid())
+		{
+			// like TR_IMPORT_TWO_PASS, the way pass marks the nodes inside
+			ios.setClip(clip);
+			ios.setPass(TrImportOsmStream::WayPass);
+			read_ok = readFile(filename, ios, &osm2_world);
+			if(read_ok)
+			{
+				ios.setPass(TrImportOsmStream::NodePass);
+				read_ok = readFile(filename, ios, &osm2_world);
+			}
+		}
+		else if(m_import_mode & TR_IMPORT_TWO_PASS)
+		{
+			ios.setPass(TrImportOsmStream::WayPass);
+			read_ok = readFile(filename, ios, &osm2_world);
+			if(read_ok)
+			{
+				ios.setPass(TrImportOsmStream::NodePass);
+				read_ok = readFile(filename, ios, &osm2_world);
+			}
+		}
+		else
 		{
-            appendPoi(&osm2_world, i.value());
+			read_ok = readFile(filename, ios, &osm2_world);
 		}
-		ios.setNodeIds(osm2_world);
+		if(!read_ok)
+		{
+			TR_ERR << "file error, reading " << filename;
+			return false;
+		}
+		TR_INF << "read:" << stage_timer.restart() << "ms";
+		if(use_cache && (!m_cache->isMapped()))
+			m_cache->save(filename, cache_mode, osm2_world, ios.getRelationList());
 #ifdef OSM_C_FILTER
         m_nodeSize = osm2_world.info.node.count;
 #else
         m_nodeSize = osm2_world.node_count;
 #endif
-        m_nodes = osm2_world.nodes;
-		for (int i = 0; i<ios.getRelationList().size(); i++)
-		{
-#ifdef TESTX
-			createRelFace(ios.getRelationList()[i], osm2_world.ways, osm2_world.info.way.count);
-#endif
-        }
+        m_node_ids = osm2_world.node_ids;
+        m_node_coor = osm2_world.node_coor;
+        m_pois = osm2_world.pois;
+		// the faces are created with the node index, see 'createRelFaces'
+		m_relations = (use_cache && m_cache->isMapped()) ?
+				m_cache->getRelationList() : ios.getRelationList();
 		//return true;
 	}
 	else
@@ -208,18 +275,22 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
 			TR_ERR << "file error, reading " << filename;
 			return false;
 		}
+		TR_INF << "read:" << stage_timer.restart() << "ms";
 #endif
 	}
 
-	QMap<QString, name_set>::const_iterator i = osm2_world.m_name_map.constBegin();
-	while (i != osm2_world.m_name_map.constEnd())
+	// the names in the order of the final ids 1..n
+	const TrOsmNameDict & names = osm2_world.m_names;
+	QVector<TrGeoObject *> name_elems;
+	name_elems.reserve(names.size());
+	for(int id = 1; id <= names.size(); id++)
 	{
 		TrNameElement * elem = new TrNameElement;
-		elem->setName(i.key());
-		elem->setNameNumber(i.value().number);
-		name_list.appendObject(elem, i.value().id);
-		++i;
+		elem->setName(names.name(id));
+		elem->setNameNumber(names.number(id));
+		name_elems.append(elem);
 	}
+	name_list.appendObjects(name_elems, 1);
 #ifdef TESTX
 	for(unsigned int i=0; i < osm2_world.info.point.count; i++)
 	{
@@ -227,34 +298,22 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
 		appendPoi(&osm2_world, osm2_world.points[i]);
 	}
  #endif
- #ifdef OSM_C_FILTER
-    for(unsigned int i=0; i < osm2_world.info.node.count; i++)
- #else
-    for(unsigned int i=0; i < osm2_world.node_count; i++)
- #endif
+	// only the tagged nodes, not all way points
+	for(size_t i = 0; i < osm2_world.poi_count; i++)
 	{
-		// way points with POI info
-		appendPoi(&osm2_world, osm2_world.nodes[i]);
+		const Poi_t & poi = osm2_world.pois[i];
+		appendPoi(poi, names.name(poi.name_id));
 	}
-#ifdef OSM_C_FILTER
-    m_nodeSize = osm2_world.info.node.count;
-#else
-    m_nodeSize = osm2_world.node_count;
-#endif
-	m_nodes = osm2_world.nodes;
 #ifdef OSM_C_FILTER
     for(unsigned int i=0; i < osm2_world.info.rel.count; i++)
 	{
 		if(count_outer(&(osm2_world.relations[i])))
-		{
-			createRelFace((osm2_world.relations[i]), osm2_world.ways, osm2_world.info.way.count);
-		}
+			m_relations.append(osm2_world.relations[i]);
     }
 #endif
 	//printRawData(&osm2_world);
 
-	QVector <RawNode> osm_nodes;
-	RawNode act_node;
+	QVector <uint32_t> way_slots;
 #ifdef OSM_C_FILTER
     m_nodeSize = osm2_world.info.node.count;
 	m_waySize = osm2_world.info.way.count;
@@ -263,7 +322,32 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
     m_waySize = osm2_world.way_count;
 #endif
 	m_ways = osm2_world.ways;
-	m_nodes = osm2_world.nodes;
+	m_nd_refs = osm2_world.nd_refs;
+	m_node_ids = osm2_world.node_ids;
+	m_node_coor = osm2_world.node_coor;
+
+	TrOsmNodeIndex::Mode index_mode = TrOsmNodeIndex::Auto;
+	if(m_import_mode & TR_IMPORT_INDEX_SORTED)
+		index_mode = TrOsmNodeIndex::Sorted;
+	if(m_import_mode & TR_IMPORT_INDEX_DENSE)
+		index_mode = TrOsmNodeIndex::Dense;
+	if(!m_node_index.create(m_node_ids, m_nodeSize, index_mode))
+	{
+		TR_ERR << "no node index" << filename;
+		return false;
+	}
+	// the ids are kept for the node pool, see 'createNodePool'
+
+	createRelFaces();
+
+	// degree counters of the nets, 3 bytes for each node
+	free(m_degree);
+	m_degree = static_cast<NodeDegree_t *>(calloc(m_nodeSize > 0 ? m_nodeSize : 1, sizeof(NodeDegree_t)));
+	if(m_degree == nullptr)
+	{
+		TR_ERR << "no memory for the node degrees" << m_nodeSize;
+		return false;
+	}
 
 	emit valueChanged(20);
 
@@ -273,8 +357,7 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
     for(unsigned int i=0; i < m_waySize; i++)
     {
 		add_it = true;
-		olink = new TrOsmLink();
-		//link->setId(osm2_world.ways[i].id);	// TODO: setId unused?
+		memset(&raw_way, 0x00, sizeof(raw_way));
 
 		if(i == level * count)
 		{
@@ -282,33 +365,32 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
 			count++;
 		}
 
+		const uint64_t * nd_id = m_nd_refs + osm2_world.ways[i].nd_ofs;
 		for(int j=0; j < osm2_world.ways[i].n_nd_id; j++)
 		{
-            int id = findNode(osm2_world.nodes, m_nodeSize,
-                osm2_world.ways[i].nd_id[j]);
+            int64_t id = m_node_index.find(nd_id[j]);
 
 			if(id < 0)
 			{
-				printf("findNode: cannot find %lu %i %i %i\n",
-					osm2_world.ways[i].nd_id[j], id, i, j);
+				printf("findNode: cannot find %lu %i %i\n",
+					nd_id[j], i, j);
 				add_it = false;
+				continue;
 			}
 
-			pt.x = (osm2_world.nodes[id].x/100.0);
-			pt.y = (osm2_world.nodes[id].y/100.0);
-	
-			act_node.id = osm2_world.ways[i].nd_id[j];
-			act_node.x = osm2_world.nodes[id].x;
-			act_node.y = osm2_world.nodes[id].y;
-			olink->addRawNode(osm2_world.ways[i].nd_id[j]);
-			olink->appendPolyPoint(pt);
-			osm_nodes.append(act_node);
+			way_slots.append(static_cast<uint32_t>(id));
 		}
 
 		if(add_it)
 		{
 			uint16_t rd_class = 0;
 
+			// all node ids are found, the span of the way is used
+			raw_way.nd_ofs = osm2_world.ways[i].nd_ofs;
+			raw_way.slot_ofs = static_cast<uint64_t>(m_raw_slots.size());
+			raw_way.n_nd = static_cast<uint32_t>(osm2_world.ways[i].n_nd_id);
+			raw_way.name_id = static_cast<uint32_t>(osm2_world.ways[i].name_id);
+
 			// TODO: check parameter
 			switch(osm2_world.ways[i].type & 0x00000000000f0000)
 			{
@@ -319,62 +401,58 @@ bool TrImportOsm::read(const QString & filename, TrMapList & name_list)
 				if(osm2_world.ways[i].type & FLAG_RAMP)
 					rd_class |= TR_LINK_RAMP_FLAG;
 
-				olink->setRdClass(rd_class);
+				raw_way.rd_class = rd_class;
 
-				olink->setOneWay((osm2_world.ways[i].type & 0x0000000f00000000) >> 32);   // 0x0600) >> 9);
+				raw_way.oneway = (osm2_world.ways[i].type & 0x0000000f00000000) >> 32;   // 0x0600) >> 9);
 
-				// set both modes...
-				olink->setOsmLanes(osm2_world.ways[i].lanes);
-				olink->setLanes(osm2_world.ways[i].lanes);
+				// set both modes, 'lanes' as TrMapLinkRoad::setLanes
+				raw_way.osm_lanes = osm2_world.ways[i].lanes;
+				raw_way.lanes = static_cast<uint8_t>(osm2_world.ways[i].lanes);
+				if(raw_way.lanes == 0)
+					raw_way.lanes = 1;
 
-				olink->setWidth(osm2_world.ways[i].width);
-				olink->setOsmWidth(osm2_world.ways[i].width);
-
-				olink->setNameId(osm2_world.ways[i].name_id);
+				raw_way.width = osm2_world.ways[i].width;
 
 				// parking lanes
-				olink->setOsmParking(osm2_world.ways[i].parking);
+				raw_way.parking = osm2_world.ways[i].parking;
 
 				// TODO: set a flag for the SIDEWALK option?
 				if(osm2_world.ways[i].type & FLAG_SIDEWALK)
-					olink->setOsmSidewalk(1);
+					raw_way.sidewalk = 1;
 
-				road_raw_link_list.append(olink);
+				road_raw_link_list.append(raw_way);
+				m_raw_slots += way_slots;
 
-				addRawNodes(olink->getRawNodes(), road_poly_nodes, olink->getOneWay());
-				addRawCoor(&osm_nodes, road_poly_nodes);
+				addRawNodes(way_slots.constData(), way_slots.size(), OSM_NET_ROAD, raw_way.oneway);
 				break;
 
 			case TYPE_RAIL:
-				olink->setRdClass(setTrainType(olink, osm2_world.ways[i].type));
+				raw_way.rd_class = setTrainType(osm2_world.ways[i].type);
 				// TODO: set the name of the train connection?
-                olink->setNameId(static_cast<uint32_t>(osm2_world.ways[i].name_id));
 
-				rail_raw_link_list.append(olink);
-				if(addRawNodes(olink->getRawNodes(), rail_poly_nodes, olink->getOneWay()) == true)
-					addRawCoor(&osm_nodes, rail_poly_nodes);
+				rail_raw_link_list.append(raw_way);
+				m_raw_slots += way_slots;
+
+				addRawNodes(way_slots.constData(), way_slots.size(), OSM_NET_RAIL, raw_way.oneway);
 				break;
 
 			case TYPE_STREAM:
 				//TR_MSG << "stream";
-				olink->setRdClass(setWaterType(olink, osm2_world.ways[i].type));
+				raw_way.rd_class = setWaterType(osm2_world.ways[i].type);
 				// TODO: set the name of the river?
-                olink->setNameId(static_cast<uint32_t>(osm2_world.ways[i].name_id));
-				stream_raw_link_list.append(olink);
+				stream_raw_link_list.append(raw_way);
+				m_raw_slots += way_slots;
 
-				if(addRawNodes(olink->getRawNodes(), stream_poly_nodes, olink->getOneWay()) == true)
-					addRawCoor(&osm_nodes, stream_poly_nodes);
+				addRawNodes(way_slots.constData(), way_slots.size(), OSM_NET_STREAM, raw_way.oneway);
 				break;
 
 			default:
-				delete olink;
 				break;
 			}
-			osm_nodes.clear();
 		}
-		else
-			delete olink;
+		way_slots.clear();
 	}
+	TR_INF << "raw ways:" << stage_timer.restart() << "ms";
 	emit valueChanged(100);
 	return true;
 }
@@ -394,7 +472,7 @@ bool TrImportOsm::createNet(TrMapNet * osm_net, QString name)
 	// from 'tr_map_net'
 	if(name == "road")
 	{
-		if(finalizeNet(road_raw_link_list, road_poly_nodes, "net", osm_net, true) == false)
+		if(finalizeNet(road_raw_link_list, OSM_NET_ROAD, name, osm_net, true) == false)
 		{
 			TR_ERR << "read (road)";
 			return false;
@@ -402,7 +480,7 @@ bool TrImportOsm::createNet(TrMapNet * osm_net, QString name)
 	}
 	if(name == "rail")
 	{
-		if(finalizeNet(rail_raw_link_list, rail_poly_nodes, "net", osm_net, false) == false)
+		if(finalizeNet(rail_raw_link_list, OSM_NET_RAIL, name, osm_net, false) == false)
 		{
 			TR_ERR << "read (rail)";
 			return false;
@@ -410,12 +488,150 @@ bool TrImportOsm::createNet(TrMapNet * osm_net, QString name)
 	}
 	if(name == "stream")
 	{
-		if(finalizeNet(stream_raw_link_list, stream_poly_nodes, "net", osm_net, false) == false)
+		if(finalizeNet(stream_raw_link_list, OSM_NET_STREAM, name, osm_net, false) == false)
 		{
 			TR_ERR << "read (stream)";
 			return false;
 		}
 	}
+	if(m_import_mode & TR_IMPORT_MERGE_CHAINS)
+		osm_net->mergeChains();
+	return true;
+}
+
+bool TrImportOsm::createNets(const QVector<TrMapNet *> & nets, const QStringList & names,
+		QVector<bool> & net_ok)
+{
+	net_ok.fill(false, nets.size());
+	if(nets.size() != names.size())
+	{
+		TR_ERR << "nets" << nets.size() << "names" << names.size();
+		return false;
+	}
+
+	// one job for each raw list, a second net of the same name is empty
+	QVector<int> jobs;
+	QStringList job_names;
+	for(int i = 0; i < names.size(); ++i)
+	{
+		if(!job_names.contains(names[i]))
+		{
+			jobs.append(i);
+			job_names.append(names[i]);
+		}
+	}
+
+	// read only by the jobs
+	if(!createNodePool())
+		return false;
+
+	QVector<char> ok(nets.size(), 1);
+	char * ok_data = ok.data();
+	auto create = [&](int i) { ok_data[i] = createNet(nets[i], names[i]); };
+
+	if((m_import_mode & TR_IMPORT_PARALLEL) && (jobs.size() > 1))
+		QtConcurrent::blockingMap(jobs, create);
+	else
+	{
+		for(int i = 0; i < jobs.size(); ++i)
+			create(jobs[i]);
+	}
+
+	for(int i = 0; i < names.size(); ++i)
+	{
+		if(!jobs.contains(i))
+			ok_data[i] = createNet(nets[i], names[i]);
+	}
+
+	// the shared arrays of the raw ways
+	m_raw_slots.clear();
+	m_raw_slots.squeeze();
+	free(m_pool_slots);
+	m_pool_slots = nullptr;
+	free(m_degree);
+	m_degree = nullptr;
+
+	// level crossings, bridges...: join of each pair of nets by the pool
+	for(int i = 0; i < jobs.size(); ++i)
+	{
+		for(int j = i + 1; j < jobs.size(); ++j)
+		{
+			if(ok_data[jobs[i]] && ok_data[jobs[j]])
+			{
+				int n_shared = nets[jobs[i]]->markSharedNodes(*nets[jobs[j]]);
+				TR_INF << "shared nodes" << names[jobs[i]] << names[jobs[j]] << n_shared;
+			}
+		}
+	}
+
+	for(int i = 0; i < ok.size(); ++i)
+		net_ok[i] = (ok[i] != 0);
+	return !ok.contains(0);
+}
+
+// one entry for each node with links in a net, in the order of the
+// node array (sorted ids)
+bool TrImportOsm::createNodePool()
+{
+	if(m_degree == nullptr)
+	{
+		TR_ERR << "no node degrees";
+		return false;
+	}
+	if(m_node_ids == nullptr)
+	{
+		TR_ERR << "no node ids";
+		return false;
+	}
+
+	free(m_pool_slots);
+	m_pool_slots = static_cast<int32_t *>(malloc((m_nodeSize > 0 ? m_nodeSize : 1) * sizeof(int32_t)));
+	if(m_pool_slots == nullptr)
+	{
+		TR_ERR << "no memory for the pool slots" << m_nodeSize;
+		return false;
+	}
+
+	int n_pool = 0;
+	for(size_t i = 0; i < m_nodeSize; ++i)
+	{
+		for(int net = 0; net < OSM_NET_COUNT; ++net)
+		{
+			if(m_degree[i].deg[net])
+			{
+				++n_pool;
+				break;
+			}
+		}
+	}
+
+	m_node_pool.reset(new TrMapNodePool);
+	m_node_pool->reserve(n_pool);
+	for(size_t i = 0; i < m_nodeSize; ++i)
+	{
+		uint8_t nets = 0;
+		for(int net = 0; net < OSM_NET_COUNT; ++net)
+		{
+			if(m_degree[i].deg[net])
+				nets |= static_cast<uint8_t>(1 << net);
+		}
+		m_pool_slots[i] = -1;
+		if(nets)
+		{
+			TrPoint32 pt;
+			pt.x = m_node_coor[i].x;
+			pt.y = m_node_coor[i].y;
+			m_pool_slots[i] = m_node_pool->appendNode(m_node_ids[i], pt, nets);
+		}
+	}
+	TR_INF << "node pool:" << m_node_pool->size() << "of" << m_nodeSize;
+
+	// the index has the ids, only the coordinates are used later
+	if((m_cache == nullptr) || (!m_cache->isMapped()))
+	{
+		free(m_node_ids);
+		m_node_ids = nullptr;
+	}
 	return true;
 }
 
@@ -423,11 +639,11 @@ bool TrImportOsm::appendFacePoint(uint64_t id, TrMapFace & face)
 {
 	TrPoint pt;
 
-    int nd_id = findNode(m_nodes, static_cast<int>(m_nodeSize), id);
+    int64_t nd_id = m_node_index.find(id);
 	if(nd_id < 0)
 		return false;
-	pt.x = (m_nodes[nd_id].x/100.0);
-	pt.y = (m_nodes[nd_id].y/100.0);
+	pt.x = (m_node_coor[nd_id].x/100.0);
+	pt.y = (m_node_coor[nd_id].y/100.0);
 
 	face.appendPolyPoint(pt);
 	return true;
@@ -435,11 +651,13 @@ bool TrImportOsm::appendFacePoint(uint64_t id, TrMapFace & face)
 
 bool TrImportOsm::appendFacePoints(const Way_t & way, TrMapFace & face, bool dir)
 {
+	const uint64_t * nd_id = m_nd_refs + way.nd_ofs;
+
 	if(dir)
 	{
 		for(int i= (way.n_nd_id -1); i ; i--)
 		{
-			if(!appendFacePoint(way.nd_id[i], face))
+			if(!appendFacePoint(nd_id[i], face))
 				return false;
 		}
 	}
@@ -447,7 +665,7 @@ bool TrImportOsm::appendFacePoints(const Way_t & way, TrMapFace & face, bool dir
 	{
 		for(int i=0; i < way.n_nd_id; i++)
 		{
-			if(!appendFacePoint(way.nd_id[i], face))
+			if(!appendFacePoint(nd_id[i], face))
 				return false;
 		}
 	}
@@ -456,10 +674,12 @@ bool TrImportOsm::appendFacePoints(const Way_t & way, TrMapFace & face, bool dir
 
 int TrImportOsm::checkDir(const Way_t & way1, const Way_t & way2)
 {
-	uint64_t nd1 = way1.nd_id[0];
-	uint64_t nd2 = way1.nd_id[way1.n_nd_id -1];
-	uint64_t nd3 = way2.nd_id[0];
-	uint64_t nd4 = way2.nd_id[way2.n_nd_id -1];
+	const uint64_t * nd_id1 = m_nd_refs + way1.nd_ofs;
+	const uint64_t * nd_id2 = m_nd_refs + way2.nd_ofs;
+	uint64_t nd1 = nd_id1[0];
+	uint64_t nd2 = nd_id1[way1.n_nd_id -1];
+	uint64_t nd3 = nd_id2[0];
+	uint64_t nd4 = nd_id2[way2.n_nd_id -1];
 	//TR_INF << nd1 << nd2 << nd3 << nd4;
 
 	if((nd1 == nd3) && (nd2 != nd4))
@@ -481,144 +701,179 @@ int TrImportOsm::checkDir(const Way_t & way1, const Way_t & way2)
 	return 0;
 }
 
-// TODO: create a function for blocks of outer or inner
-#ifdef OSM_C_FILTER
-void TrImportOsm::createRelFace(Rel_t & relation, Way_t * ways, uint64_t n_way)
+// multipolygon relations of both filters, the rings on all cores
+void TrImportOsm::createRelFaces()
+{
+	if(m_relations.isEmpty())
+		return;
+
+	QElapsedTimer stage_timer;
+	stage_timer.start();
+
+	TrOsmRing ring(m_ways, m_waySize, m_nd_refs, m_node_index, m_node_coor);
+	QVector<QVector<TrMapFace *> > faces(m_relations.size());
+	QVector<int> jobs(m_relations.size());
+	for(int i = 0; i < jobs.size(); ++i)
+		jobs[i] = i;
+
+	const Rel_t * rel_data = m_relations.constData();
+	QVector<TrMapFace *> * face_data = faces.data();
+	auto create = [&](int i) { ring.createFaces(rel_data[i], face_data[i]); };
+	if((m_import_mode & TR_IMPORT_PARALLEL) && (jobs.size() > 1))
+		QtConcurrent::blockingMap(jobs, create);
+	else
+	{
+		for(int i = 0; i < jobs.size(); ++i)
+			create(i);
+	}
+
+	// in the order of the relations
+	int n_face = 0;
+	for(int i = 0; i < faces.size(); ++i)
+	{
+		face_list.append(faces[i]);
+		n_face += faces[i].size();
+	}
+	TR_INF << "relations:" << m_relations.size() << "faces:" << n_face
+		<< "rings:" << stage_timer.elapsed() << "ms";
+	m_relations.clear();
+}
+
+// type of the ways of a face layer, 0: unknown name
+static uint64_t faceType(const QString & name)
+{
+	if(name == "nature")
+		return TYPE_NATURAL;
+
+	if(name == "building")
+		return TYPE_BUILDING;
+
+	if(name == "landuse")
+		return TYPE_LANDUSE;
+
+	return 0;
+}
+
+void TrImportOsm::resolveFacePart(OsmFacePart & part)
 {
-	int64_t idx1 = (-1);
-	int64_t idx2 = (-1);
-	bool first = true;
-	TrMapFace * face = nullptr; //new TrMapFace();
-	//face->appendPolygon(0);
-	for(uint32_t i = 0; i< relation.r_count; i++)
-	{
-		//idx_1 = findWay(world->ways, world->info.way.count, world->rel_id_buf[1].id);
-		if(relation.members[i].flags & REL_MEM_ROLE_OUT)
+	part.faces.resize(part.n_way);
+	for(int i = 0; i < part.n_way; ++i)
+	{
+		const Way_t & way = m_ways[part.ways[i].way];
+
+		// TODO: use multipolygon
+		TrMapFace * face = new TrMapFace();
+		face->appendPolygon(0x00);
+		if(appendFacePoints(way, *face, true))
 		{
-			if(face == nullptr)
-			{
-				face = new TrMapFace();
-				face->appendPolygon(0);
-			}
-			idx1 = findWay(ways, n_way, relation.members[i].id);
-			if(idx1 == (-1))
-				return;
-			if(idx1 != (-1))
-			{
-				if(idx2 != (-1))
-				{
-					int code = checkDir(ways[idx2], ways[idx1]);
-					if(first)
-					{
-						//TR_INF << "first" << ways[idx2].id << ways[idx1].id << code;
-						if((code == 2) || (code == 1))
-							appendFacePoints(ways[idx2], *face, true);
-						if((code == 3) || (code == 4))
-							appendFacePoints(ways[idx2], *face, false);
-						first = false;
-					}
-					else
-					{
-						//TR_INF << "next" << ways[idx2].id << " # " << ways[idx1].id << code;
-					}
-					if((code == 2) || (code == 4))
-						appendFacePoints(ways[idx1], *face, true);
-					if((code == 1) || (code == 3))
-						appendFacePoints(ways[idx1], *face, false);
-				}
-				idx2 = idx1;
-				// TODO: way1 way2 -> dir
-				//appendFacePoints(ways[idx1], *face, true);
-			}
-			//TR_INF << "member: " << relation.members[i].id << idx;
+			uint64_t type = (way.type & 0x000000f000000000) >> 24; //36;
+			face->setType((way.type & 0x000000000000000f) | type);
 		}
-		if(relation.members[i].flags & REL_MEM_ROLE_IN)
+		else
 		{
-			if(face != nullptr)
-			{
-				face->setFaceClass(relation.flags >> 16);
-				face->setType(relation.flags | 0x4000);
-				face_list.append(face);
-				idx1 = (-1);
-				idx2 = (-1);
-				first = true;
-				face = nullptr;
-			}
+			delete face;
+			face = nullptr;
 		}
-		//face->setFaceClass(relation.flags >> 16);
-		//face->setType(relation.flags | 0x4000);
-	}
-	if(face != nullptr)
-	{
-		face->setFaceClass(relation.flags >> 16);
-		face->setType(relation.flags | 0x4000);
-		face_list.append(face);
+		part.faces[i] = face;
 	}
 }
-#endif
 
-bool TrImportOsm::createFaceList(TrMapList * osm_list, QString name)
+bool TrImportOsm::createFaceLists(const QVector<TrMapList *> & osm_lists, const QStringList & names)
 {
-	uint64_t type = 0xffffffffffffffff;
-
-	if(osm_list == nullptr)
+	if(osm_lists.size() != names.size())
 	{
-		TR_MSG << "error NULL pointer at " << name;
+		TR_ERR << "lists" << osm_lists.size() << "names" << names.size();
 		return false;
 	}
 
-    TrMapFace * face = nullptr;
+	QVector<uint64_t> types(names.size());
+	for(int j = 0; j < names.size(); ++j)
+	{
+		if(osm_lists[j] == nullptr)
+		{
+			TR_MSG << "error NULL pointer at " << names[j];
+			return false;
+		}
+		types[j] = faceType(names[j]);
+	}
 
-	if(name == "nature")
-		type = TYPE_NATURAL;    // 0x00000005
+	QElapsedTimer stage_timer;
+	stage_timer.start();
 
-	if(name == "building")
-		type = TYPE_BUILDING;	// 0x00000007
+	// one pass, the ways are put into the buckets of all lists
+	QVector<OsmFaceWay_t> face_ways;
+	OsmFaceWay_t fway;
+	for(size_t i = 0; i < m_waySize; i++)
+	{
+		uint64_t type = m_ways[i].type & 0x0000000000f00000;
+		if(type == 0)
+			continue;
 
-	if(name == "landuse")
-		type = TYPE_LANDUSE;	// 0x00000006
+		for(int j = 0; j < types.size(); ++j)
+		{
+			if(type == types[j])
+			{
+				fway.way = i;
+				fway.list = j;
+				face_ways.append(fway);
+			}
+		}
+	}
+
+	int n_part = 1;
+	if(m_import_mode & TR_IMPORT_PARALLEL)
+	{
+		n_part = qMin(QThread::idealThreadCount(), face_ways.size() / TR_IMPORT_PART_WAYS);
+		if(n_part < 1)
+			n_part = 1;
+	}
 
-	// TR_MSG << hex << world_->way_flags << " -> " << QString((const char*)sax->tag_start);
+	QVector<OsmFacePart> parts(n_part);
+	int n_way = face_ways.size() / n_part;
+	for (int i = 0; i < n_part; ++i)
+	{
+		parts[i].ways = face_ways.constData() + i * n_way;
+		parts[i].n_way = (i == n_part - 1) ? face_ways.size() - i * n_way : n_way;
+	}
+
+	if(n_part > 1)
+		QtConcurrent::blockingMap(parts, [this](OsmFacePart & part) { resolveFacePart(part); });
+	else
+		resolveFacePart(parts[0]);
+	qint64 resolve_ms = stage_timer.restart();
 
-	for(unsigned int i=0; i < m_waySize; i++)
+	// in the order of the ways
+	for (int i = 0; i < n_part; ++i)
 	{
-		if((m_ways[i].type & 0x0000000000f00000) == type)
+		for(int k = 0; k < parts[i].n_way; ++k)
 		{
-			// TODO: use multipolygon
-			face = new TrMapFace();
-			face->appendPolygon(0x00);
-			//if((osm2_world.ways[i].type & 0x0F) > 3)
-			if(appendFacePoints(m_ways[i], *face, true))
-			{
-				uint64_t type = (m_ways[i].type & 0x000000f000000000) >> 24; //36;
-				face->setType((m_ways[i].type & 0x000000000000000f) | type);
-				osm_list->appendObject(face);
-			}
-			else
-			{
-				if(face != nullptr)
-				{
-					delete face;
-					face = nullptr;
-				}
-			}
+			if(parts[i].faces[k] != nullptr)
+				osm_lists[parts[i].ways[k].list]->appendObject(parts[i].faces[k]);
 		}
+		parts[i].faces.clear();
 	}
+
 	for (int i = 0; i < face_list.size(); ++i)
 	{
 		uint64_t f_class = face_list[i]->getFaceClass();
 		//TR_INF << HEX << face_list[i]->getType() << face_list[i]->getFaceClass() << TYPE_NATURAL;
-		if((name == "nature") && ((f_class << 16) & TYPE_NATURAL))
-			osm_list->appendObject(face_list[i]);
-		if((name == "landuse") && ((f_class << 16) & TYPE_LANDUSE))
-			osm_list->appendObject(face_list[i]);
-		if((name == "building") && ((f_class << 16) & TYPE_BUILDING))
-			osm_list->appendObject(face_list[i]);
+		for(int j = 0; j < types.size(); ++j)
+		{
+			if((f_class << 16) & types[j])
+				osm_lists[j]->appendObject(face_list[i]);
+		}
 		//face_list[i]->setFaceClass(1);
 	}
+	TR_INF << "faces:" << face_ways.size() << "parts:" << n_part << "resolve:" << resolve_ms
+		<< "ms append:" << stage_timer.elapsed() << "ms";
 	return true;
 }
 
+bool TrImportOsm::createFaceList(TrMapList * osm_list, QString name)
+{
+	return createFaceLists(QVector<TrMapList *>(1, osm_list), QStringList(name));
+}
+
 
 
 TrMapList * TrImportOsm::createPoiMap(QString name)
@@ -627,150 +882,117 @@ TrMapList * TrImportOsm::createPoiMap(QString name)
 }
 
 
-bool TrImportOsm::addNode(uint64_t id, QMap<uint64_t, PolyNode> & poly_nodes)
+// in and out links of the way, 4 bits each
+static inline void addDegree(uint8_t & deg, uint8_t n_in, uint8_t n_out)
 {
-	//printf("TrImportOsm2::addNode %i\n", id);
-
-	if(poly_nodes.find(id) == poly_nodes.end())
-	{
-		PolyNode act_node;
-
-		act_node.x = 0;
-		act_node.y = 0;
-		act_node.n_in = act_node.n_out = act_node.flags = 0x00;
+	uint8_t deg_in = deg & 0x0f;
+	uint8_t deg_out = deg >> 4;
 
-		poly_nodes[id] = act_node;
-
-		return true;
-	}
-	return false;
+	deg_in = (deg_in + n_in > 0x0f) ? 0x0f : deg_in + n_in;
+	deg_out = (deg_out + n_out > 0x0f) ? 0x0f : deg_out + n_out;
+	deg = static_cast<uint8_t>((deg_out << 4) | deg_in);
 }
 
+static inline uint8_t degreeOut(uint8_t deg)
+{
+	return deg >> 4;
+}
 
-bool TrImportOsm::addRawNodes(QVector <uint64_t> * nodes, QMap<uint64_t, PolyNode> & poly_nodes, uint8_t dir)
+bool TrImportOsm::addRawNodes(const uint32_t * slots, int n_nodes, int net, uint8_t dir)
 {
-	if(nodes->size() <2)
+	if(n_nodes <2)
 		return false;
 
-	for(int i = 0; i < nodes->size(); ++i)
-	{
-		if(this->addNode(nodes->at(i), poly_nodes) == false)
-        {
-            //printf("TrImportOsm2::addRawNodes error\n");
-        }
-        this->addNode(nodes->at(i), poly_nodes);
-	}
-	for(int i = 0; i < (nodes->size()); ++i)
+	for(int i = 0; i < n_nodes; ++i)
 	{
-		poly_nodes[nodes->at(i)].n_out++;
-		poly_nodes[nodes->at(i)].n_in++;
-		if(!dir)
+		uint8_t n_in = 1;
+		uint8_t n_out = 1;
+
+		// both directions: twice, but once at the ends
+		if((!dir) && (i > 0) && (i < n_nodes - 1))
 		{
-			poly_nodes[nodes->at(i)].n_out++;
-			poly_nodes[nodes->at(i)].n_in++;
+			n_in = 2;
+			n_out = 2;
 		}
-	}
-	if(!dir)
-	{
-		poly_nodes[nodes->at(0)].n_in--;
-		poly_nodes[nodes->at(0)].n_out--;
-		poly_nodes[nodes->at(nodes->size()-1)].n_in--;
-		poly_nodes[nodes->at(nodes->size()-1)].n_out--;
-	}
-	if(dir == 1)
-		poly_nodes[nodes->at(0)].n_in--;
+		if((dir == 1) && (i == 0))
+			n_in = 0;
 
-	if(dir == 2)
-		poly_nodes[nodes->at(nodes->size()-1)].n_out--;
+		if((dir == 2) && (i == n_nodes - 1))
+			n_out = 0;
 
+		addDegree(m_degree[slots[i]].deg[net], n_in, n_out);
+	}
 	return true;
 }
 
-void TrImportOsm::addRawCoor(QVector <RawNode> * nodes, QMap<uint64_t, PolyNode> & poly_nodes)
+bool TrImportOsm::addNodeObj(TrMapList * node_map, const OsmPartNode_t & node)
 {
-	for(int i = 0; i < nodes->size(); ++i)
+	int32_t pool_slot = m_pool_slots[node.slot];
+	if(pool_slot < 0)
 	{
-		if(poly_nodes.find(nodes->at(i).id) == poly_nodes.end())
-		{
-			printf("node id not found %lu\n", nodes->at(i).id);
-		}
-		else
-		{
-			poly_nodes[nodes->at(i).id].x = nodes->at(i).x;
-			poly_nodes[nodes->at(i).id].y = nodes->at(i).y;
-		}
+		TR_WRN << "node not in the pool" << node.id;
+		return false;
 	}
-}
-
-bool TrImportOsm::addNodeObj(TrMapList * node_map, int64_t id, double x, double y)
-{
-    if(node_map->getMapObject(id) == nullptr)
+	if(node_map->getMapObject(node.id) == nullptr)
 	{
 		TrMapNode * opt = new TrMapNode;
 
-		TrPoint pt;
-		pt.x = x;
-		pt.y = y;
-
-		opt->setPoint(pt);
-		opt->setGeoId(id);
+		opt->setPoint(m_node_pool->getPoint(pool_slot));
+		opt->setGeoId(node.id);
 
-		return node_map->appendObject(opt, id);
+		return node_map->appendObject(opt, node.id);
 	}
 	return false;
 }
 
-bool TrImportOsm::cutLink(TrOsmLink * olink, uint64_t * id,
-	QMap<uint64_t, PolyNode> & poly_nodes, TrMapNet * osm_net, bool is_road)
+bool TrImportOsm::cutLink(const OsmRawWay_t & raw_way, OsmNetPart & part)
 {
-	QVector <uint64_t> * raw = olink->getRawNodes();
-	TrPoint pt;
+	const uint64_t * raw = m_nd_refs + raw_way.nd_ofs;
+	const uint32_t * slot = m_raw_slots.constData() + raw_way.slot_ofs;
+	int n_raw = static_cast<int>(raw_way.n_nd);
+	bool is_road = part.is_road;
 	int in_out_limit = 2;
     TrGeoPolygon * poly = nullptr;
 	int64_t i_idx = 0;
     uint64_t prim_id = 0;
 
-	TrMapList * primive_map = osm_net->getNetList(TR_MASK_SELECT_POLY, false);
-	TrMapList * node_map = osm_net->getNetList(TR_MASK_SELECT_POINT, false);
-
-	if(raw->size() < 2)
+	if(n_raw < 2)
 		return false;
 
 	TrMapLink * fwd = nullptr;
 	TrMapLink * bwd = nullptr;
+	// the nodes are set in 'bindPart', bwd: from the ends of the piece
+	uint64_t fwd_from = 0;
+	OsmPartLink_t plink;
 
-	addNodeObj(node_map, raw->at(0), poly_nodes[raw->at(0)].x/100.0,
-		poly_nodes[raw->at(0)].y/100.0);
-	addNodeObj(node_map, raw->at(raw->size()-1), poly_nodes[raw->at(raw->size()-1)].x/100.0,
-		poly_nodes[raw->at(raw->size()-1)].y/100.0);
+	appendPartNode(part, raw[0], slot[0]);
+	appendPartNode(part, raw[n_raw-1], slot[n_raw-1]);
 
 	bool set_sideway = false;
 	uint8_t sideway_class = 0x0f;
 
-	switch(olink->getOneWay())
+	switch(raw_way.oneway)
 	{
 	case 0:
-		fwd = olink->cloneLink(true, false, is_road);
+		fwd = TrOsmLink::cloneLink(raw_way, true, false, is_road);
 		// both directions
 		fwd->setOneWay(0x00);
-		fwd->setNodeFrom(node_map, raw->at(0));
+		fwd_from = raw[0];
 
-		bwd = olink->cloneLink(false, false, is_road);
+		bwd = TrOsmLink::cloneLink(raw_way, false, false, is_road);
 		// reverse (both directions)
 		bwd->setOneWay(TR_LINK_DIR_BWD);
-		bwd->setNodeFrom(node_map, raw->at(raw->size()-1));
 		break;
 
 	case 1:
-		fwd = olink->cloneLink(true, false, is_road);
+		fwd = TrOsmLink::cloneLink(raw_way, true, false, is_road);
 		// single direction
 		fwd->setOneWay(TR_LINK_DIR_ONEWAY);
-		fwd->setNodeFrom(node_map, raw->at(0));
-		if(olink->getOsmSidewalk() != 0)
+		fwd_from = raw[0];
+		if(raw_way.sidewalk != 0)
 		{
-			TR_MSG << olink->getOsmSidewalk();
-			bwd = olink->cloneLink(false, true, is_road);
-			bwd->setNodeFrom(node_map, raw->at(raw->size()-1));
+			TR_MSG << raw_way.sidewalk;
+			bwd = TrOsmLink::cloneLink(raw_way, false, true, is_road);
 			bwd->setOneWay(TR_LINK_DIR_BWD);
 			bwd->setRdClass(sideway_class);
 			set_sideway = true;
@@ -779,15 +1001,14 @@ bool TrImportOsm::cutLink(TrOsmLink * olink, uint64_t * id,
 		break;
 
 	case 2:
-		bwd = olink->cloneLink(false, false, is_road);
+		bwd = TrOsmLink::cloneLink(raw_way, false, false, is_road);
 		// reverse + single direction
 		bwd->setOneWay(TR_LINK_DIR_BWD | TR_LINK_DIR_ONEWAY);
-		bwd->setNodeFrom(node_map, raw->at(raw->size()-1));
-		if(olink->getOsmSidewalk() != 0)
+		if(raw_way.sidewalk != 0)
 		{
-			TR_MSG << olink->getOsmSidewalk();
-			fwd = olink->cloneLink(true, true, is_road);
-			fwd->setNodeFrom(node_map, raw->at(0));
+			TR_MSG << raw_way.sidewalk;
+			fwd = TrOsmLink::cloneLink(raw_way, true, true, is_road);
+			fwd_from = raw[0];
 			//bwd->setOneWay(TR_LINK_DIR_FWD);
 			fwd->setRdClass(sideway_class);
 			set_sideway = true;
@@ -799,132 +1020,204 @@ bool TrImportOsm::cutLink(TrOsmLink * olink, uint64_t * id,
 		break;
 	}
 
-	for (int i = 1; i < (raw->size()-1); ++i)
+	for (int i = 1; i < (n_raw-1); ++i)
 	{
-		pt.x = (poly_nodes[raw->at(i)].x/100.0);
-		pt.y = (poly_nodes[raw->at(i)].y/100.0);
-
-		// double use as point and POI
-		TrGeoObject * obj = m_poi_map->getObject(raw->at(i));
-		TrMapPoi * poi = nullptr;
-		if(obj != nullptr)
+		// TODO: check the in links too?
+		if(degreeOut(m_degree[slot[i]].deg[part.net]) > in_out_limit)
 		{
-			poi = dynamic_cast<TrMapPoi *>(obj);
-		}
-
-		if((poly_nodes[raw->at(i)].n_out > in_out_limit) ||
-			(poly_nodes[raw->at(i)].n_out > in_out_limit))
-		{
-			addNodeObj(node_map, raw->at(i), pt.x, pt.y);
+			appendPartNode(part, raw[i], slot[i]);
 
+			// the points between the split nodes
+			poly = createPolygon(slot, i_idx + 1, i);
             if(poly != nullptr)
 			{
-				prim_id = primive_map->objCountMap() + 1;
-				primive_map->appendObject(poly, prim_id);
+				part.polys.append(poly);
+				prim_id = static_cast<uint64_t>(part.polys.size());
                 poly = nullptr;
 			}
 
 			if(fwd)
 			{
-				fwd->setNodeTo(node_map, raw->at(i));
-				fwd->setGeoId(prim_id);
-				osm_net->appendLink(fwd);
+				plink.link = fwd;
+				plink.node_from = fwd_from;
+				plink.node_to = raw[i];
+				plink.prim = prim_id;
+				part.links.append(plink);
 				//id_tmp = prim_id;
 
-				fwd = olink->cloneLink(true, false, is_road);
-				if(((olink->getOsmSidewalk() != 0) == (olink->getOneWay() != 0)) && set_sideway)
+				fwd = TrOsmLink::cloneLink(raw_way, true, false, is_road);
+				if(((raw_way.sidewalk != 0) == (raw_way.oneway != 0)) && set_sideway)
 					bwd->setRdClass(sideway_class);
-				fwd->setNodeFrom(node_map, raw->at(i));
+				fwd_from = raw[i];
 			}
 			if(bwd)
 			{
-				bwd->setNodeFrom(node_map, raw->at(i));
-				bwd->setNodeTo(node_map, raw->at(i_idx));
-				bwd->setGeoId(prim_id);
-				osm_net->appendLink(bwd);
+				plink.link = bwd;
+				plink.node_from = raw[i];
+				plink.node_to = raw[i_idx];
+				plink.prim = prim_id;
+				part.links.append(plink);
 
-				bwd = olink->cloneLink(false, false, is_road);
+				bwd = TrOsmLink::cloneLink(raw_way, false, false, is_road);
 				bwd->setOneWay(4);
-				if(((olink->getOsmSidewalk() != 0) == (olink->getOneWay() != 0)) && set_sideway)
+				if(((raw_way.sidewalk != 0) == (raw_way.oneway != 0)) && set_sideway)
 					bwd->setRdClass(sideway_class);
-				bwd->setNodeFrom(node_map, raw->at(i_idx));
 			}
 			prim_id = 0;
 			i_idx = i;
 		}
-		else
-		{
-			if(poly == nullptr)
-			{
-				poly = new TrGeoPolygon;
-			}
-			// TODO: append on local list
-			bool set = true;
-			if(poi != nullptr)
-			{
-			}
-			if(set)
-			{
-				QVector<TrPoint> next_points;
-				next_points.append(pt);
-				poly->appendPoints(next_points);
-			}
-			if(poly->getSize() == 0)
-				poly = nullptr;
-		}
 	}
 
+	poly = createPolygon(slot, i_idx + 1, n_raw - 1);
     if(poly != nullptr)
 	{
 		// TODO: check the polygon...
-		prim_id = primive_map->objCountMap() + 1;
-		primive_map->appendObject(poly, prim_id);
+		part.polys.append(poly);
+		prim_id = static_cast<uint64_t>(part.polys.size());
         poly = nullptr;
 	}
 
 	if(fwd)
 	{
-		fwd->setGeoId(prim_id);
-		osm_net->appendLink(fwd);
-		fwd->setNodeTo(node_map, raw->at(raw->size()-1));
+		plink.link = fwd;
+		plink.node_from = fwd_from;
+		plink.node_to = raw[n_raw-1];
+		plink.prim = prim_id;
+		part.links.append(plink);
 	}
 	if(bwd)
 	{
-		bwd->setGeoId(prim_id);
-		osm_net->appendLink(bwd);
-		bwd->setNodeFrom(node_map, raw->at(raw->size()-1));
-		bwd->setNodeTo(node_map, raw->at(i_idx));
+		plink.link = bwd;
+		plink.node_from = raw[n_raw-1];
+		plink.node_to = raw[i_idx];
+		plink.prim = prim_id;
+		part.links.append(plink);
 	}
 	return true;
 }
 
-
-bool TrImportOsm::finalizeNet(QVector<TrOsmLink *> raw_list, QMap<uint64_t,
-	PolyNode> & poly_nodes, QString name, TrMapNet * osm_net, bool is_road)
+// points 'first' to 'last' - 1 of a raw way, nullptr for no point
+TrGeoPolygon * TrImportOsm::createPolygon(const uint32_t * slot, int first, int last)
 {
+	if(first >= last)
+		return nullptr;
 
-	int i = 0;
-
-	uint64_t id = 1;
+	TrGeoPolygon * poly = new TrGeoPolygon;
+	TrPoint pt;
 
-	for (i = 0; i < raw_list.size(); ++i)
+	poly->reservePoints(static_cast<size_t>(last - first));
+	for (int i = first; i < last; ++i)
 	{
-		cutLink(raw_list[i], &id, poly_nodes, osm_net, is_road);
+		pt.x = (m_node_coor[slot[i]].x/100.0);
+		pt.y = (m_node_coor[slot[i]].y/100.0);
+		poly->appendPoint(pt);
 	}
+	return poly;
+}
+
+void TrImportOsm::appendPartNode(OsmNetPart & part, uint64_t id, uint32_t slot)
+{
+	OsmPartNode_t node;
 
-    //TR_MSG << raw_list.size();
+	node.id = id;
+	node.slot = slot;
+	part.nodes.append(node);
+}
 
+void TrImportOsm::cutPart(OsmNetPart & part)
+{
+	for(int i = 0; i < part.n_raw; ++i)
+	{
+		cutLink(part.raw[i], part);
+	}
+}
+
+// in the order of the parts -> same ids as a single part
+void TrImportOsm::bindPart(OsmNetPart & part, TrMapNet * osm_net)
+{
 	TrMapList * primive_map = osm_net->getNetList(TR_MASK_SELECT_POLY, false);
-	TrMapList * link_list = osm_net->getNetList(TR_MASK_SELECT_LINK, false);
+	TrMapList * node_map = osm_net->getNetList(TR_MASK_SELECT_POINT, false);
 
-	for (size_t i = 0; i < link_list->objCount(); ++i)
+	for(int i = 0; i < part.nodes.size(); ++i)
 	{
-        TrMapLink * link = dynamic_cast <TrMapLink*>(link_list->getVecObject(i));
-        if(link != nullptr)
+		addNodeObj(node_map, part.nodes[i]);
+	}
+
+	uint64_t prim_base = primive_map->objCountMap();
+	for(int i = 0; i < part.polys.size(); ++i)
+	{
+		primive_map->appendObject(part.polys[i], prim_base + i + 1);
+	}
+
+	for(int i = 0; i < part.links.size(); ++i)
+	{
+		const OsmPartLink_t & plink = part.links[i];
+
+		plink.link->setNodeFrom(node_map, plink.node_from);
+		plink.link->setNodeTo(node_map, plink.node_to);
+		// the polygon is known, no lookup by the geo id
+		if(plink.prim != 0)
 		{
-			link->setPrimiveById(primive_map);
+			plink.link->setPolygon(part.polys[plink.prim - 1]);
+			plink.link->setGeoId(prim_base + plink.prim);
 		}
+		osm_net->appendLink(plink.link);
+	}
+	part.nodes.clear();
+	part.polys.clear();
+	part.links.clear();
+}
+
+bool TrImportOsm::finalizeNet(QVector<OsmRawWay_t> & raw_list, int net,
+	QString name, TrMapNet * osm_net, bool is_road)
+{
+	int n_part = 1;
+
+	// big lists are cut on all cores, the parts are bound in order
+	if(m_import_mode & TR_IMPORT_PARALLEL)
+	{
+		n_part = qMin(QThread::idealThreadCount(), raw_list.size() / TR_IMPORT_PART_WAYS);
+		if(n_part < 1)
+			n_part = 1;
 	}
+
+	// the connectivity stays in the node objects of the net
+	if(m_node_pool.isNull())
+	{
+		TR_ERR << "no node pool" << name;
+		return false;
+	}
+	osm_net->setNodePool(m_node_pool, net);
+
+	QVector<OsmNetPart> parts(n_part);
+	int n_way = raw_list.size() / n_part;
+	for (int i = 0; i < n_part; ++i)
+	{
+		parts[i].raw = raw_list.constData() + i * n_way;
+		parts[i].n_raw = (i == n_part - 1) ? raw_list.size() - i * n_way : n_way;
+		parts[i].net = net;
+		parts[i].is_road = is_road;
+	}
+
+	QElapsedTimer stage_timer;
+	stage_timer.start();
+
+	if(n_part > 1)
+		QtConcurrent::blockingMap(parts, [this](OsmNetPart & part) { cutPart(part); });
+	else
+		cutPart(parts[0]);
+	qint64 cut_ms = stage_timer.restart();
+
+	for (int i = 0; i < n_part; ++i)
+	{
+		bindPart(parts[i], osm_net);
+	}
+	TR_INF << name << "ways:" << raw_list.size() << "parts:" << n_part << "cut:" << cut_ms
+		<< "ms bind:" << stage_timer.elapsed() << "ms";
+
+	// only the links of the net are used later
+	raw_list.clear();
+	raw_list.squeeze();
 	return true;
 }
 
@@ -37,6 +37,9 @@
 
 #include <QMap>
 #include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
 
 #include <tr_map_list.h>
 #ifdef TESTX
@@ -45,54 +48,140 @@
 
 #include <tr_map_net.h>
 
+#include "tr_osm_clip.h"
 #include "tr_osm_link.h"
+#include "tr_osm_node_index.h"
+#include "tr_osm_ring.h"
 #include "tr_map_face.h"
 
 #include "osm_types.h"
 
+// minimal number of ways for each thread, see 'finalizeNet'
+#define TR_IMPORT_PART_WAYS    4096
+
+// a link of 'OsmNetPart', the nodes and the polygon are set in 'bindPart'
+typedef struct
+{
+	TrMapLink * link;
+	uint64_t node_from;
+	uint64_t node_to;
+	// index + 1 in OsmNetPart::polys, 0: no polygon
+	uint64_t prim;
+}OsmPartLink_t;
+
+// 'slot' of the node array, the coordinates are read from the node pool in 'bindPart'
 typedef struct
 {
 	uint64_t id;
-	int32_t x;
-	int32_t y;
-}RawNode;
+	uint32_t slot;
+}OsmPartNode_t;
 
+// result of 'cutLink' for a range of a raw list
+typedef struct
+{
+	const OsmRawWay_t * raw;
+	int n_raw;
+	int net;
+	bool is_road;
+
+	// split nodes, maybe twice
+	QVector<OsmPartNode_t> nodes;
+	QVector<TrGeoPolygon *> polys;
+	QVector<OsmPartLink_t> links;
+}OsmNetPart;
+
+// a way of a face layer, 'list': index of the target list
 typedef struct
 {
-	int32_t x;
-	int32_t y;
-	uint8_t n_in;
-	uint8_t n_out;
-	uint8_t flags;
-}PolyNode;
+	size_t way;
+	int list;
+}OsmFaceWay_t;
+
+// result of 'resolveFacePart', nullptr for a way with a missing node
+typedef struct
+{
+	const OsmFaceWay_t * ways;
+	int n_way;
+
+	QVector<TrMapFace *> faces;
+}OsmFacePart;
+
+class TrImportOsmStream;
+class TrOsmCache;
+
+// import modes, see 'setImportMode'
+// read the mapped file without QXmlStreamReader
+#define TR_IMPORT_MAPPED       0x0000000000000001U
+// parse parts of the mapped XML file on all cores
+#define TR_IMPORT_PARALLEL     0x0000000000000002U
+// node index, default: chosen by the id density
+#define TR_IMPORT_INDEX_SORTED 0x0000000000000004U
+#define TR_IMPORT_INDEX_DENSE  0x0000000000000008U
+// read the ways first, then only the used nodes and POIs
+#define TR_IMPORT_TWO_PASS     0x0000000000000010U
+// use and write the binary cache of the parsed file, see TrOsmCache
+#define TR_IMPORT_CACHE        0x0000000000000020U
+// merge the links at nodes without a junction, see TrMapNet::mergeChains
+#define TR_IMPORT_MERGE_CHAINS 0x0000000000000040U
+
+// nets of the import, see 'NodeDegree_t'
+enum
+{
+	OSM_NET_ROAD = 0,
+	OSM_NET_RAIL,
+	OSM_NET_STREAM,
+	OSM_NET_COUNT
+};
+
+// links of a node in each net, index: slot of the node array,
+// in: low 4 bits, out: high 4 bits (saturated at 15)
+typedef struct
+{
+	uint8_t deg[OSM_NET_COUNT];
+}NodeDegree_t;
 
 
 class TrImportOsm : public QObject
 {
 	Q_OBJECT
 private:
-	QVector<TrOsmLink *> road_raw_link_list;
-	QMap<uint64_t, PolyNode> road_poly_nodes;
-
-	QVector<TrOsmLink *> rail_raw_link_list;
-	QMap<uint64_t, PolyNode> rail_poly_nodes;
-
-	QVector<TrOsmLink *> stream_raw_link_list;
-	QMap<uint64_t, PolyNode> stream_poly_nodes;
+	QVector<OsmRawWay_t> road_raw_link_list;
+	QVector<OsmRawWay_t> rail_raw_link_list;
+	QVector<OsmRawWay_t> stream_raw_link_list;
+	// node slots of the raw ways, OsmRawWay_t::slot_ofs
+	QVector<uint32_t> m_raw_slots;
+	// one entry for each node, shared by all nets
+	NodeDegree_t * m_degree;
+	// nodes of all nets, referenced by the nets, see 'createNodePool'
+	QSharedPointer<TrMapNodePool> m_node_pool;
+	// slot of the pool for each node, -1: in no net
+	int32_t * m_pool_slots;
 
     size_t m_waySize;	//osm2_world.info.way.count
 	Way_t * m_ways;
+	// node ids of the ways, Way_t::nd_ofs
+	uint64_t * m_nd_refs;
 
     size_t m_nodeSize;
-	// Node + POI
-	Point_t * m_nodes;
+	// ids and coordinates of the nodes, the ids are freed after the node pool is created
+	uint64_t * m_node_ids;
+	Coor_t * m_node_coor;
+	TrOsmNodeIndex m_node_index;
+	Poi_t * m_pois;
 
 	TrMapList * m_poi_map;
+	// owner of the World_t arrays on a cache hit
+	TrOsmCache * m_cache;
 	QVector<TrMapFace *> face_list;
+	// multipolygon relations, the members are owned by the stream or the cache
+	QVector<Rel_t> m_relations;
 
-	void appendPoi(void * world, const Point_t & point);
-    uint16_t setTrainType(TrOsmLink * link, uint64_t ttype);
-	uint16_t setWaterType(TrOsmLink * link, uint64_t ttype);
+	uint64_t m_import_mode;
+
+	void appendPoi(const Poi_t & poi, const QString & name);
+	bool readFile(const QString & filename, TrImportOsmStream & ios, void * world);
+    uint16_t setTrainType(uint64_t ttype);
+	uint16_t setWaterType(uint64_t ttype);
 
 protected:
 
@@ -101,30 +190,47 @@ public:
 
 	virtual ~TrImportOsm();
 
-    bool read(const QString & filename, TrMapList & name_list);
+	// TR_IMPORT_* flags, default 0: QXmlStreamReader
+	void setImportMode(uint64_t mode);
+
+	// 'clip': only the region is imported, the file is read twice and
+	// needs the nodes before the ways (sorted like all OSM files)
+    bool read(const QString & filename, TrMapList & name_list, const TrOsmClip * clip = nullptr);
 	//int64_t osmWaySize();
 
 	//void appendLinkOsm(TrOsmLink * link, QVector<TrOsmLink *> * raw_list);
-	bool addRawNodes(QVector <uint64_t> * nodes, QMap<uint64_t, PolyNode> & poly_nodes, uint8_t dir);
-	void addRawCoor(QVector <RawNode> * nodes, QMap<uint64_t, PolyNode> & poly_nodes);
-	bool addNode(uint64_t id, QMap<uint64_t, PolyNode> & poly_nodes);
-	bool addNodeObj(TrMapList * node_map, int64_t id, double x, double y);
-	bool cutLink(TrOsmLink * link, uint64_t * id, QMap<uint64_t, 
-		PolyNode> & poly_nodes, TrMapNet * osm_net, bool is_road);
-
-	bool finalizeNet(QVector<TrOsmLink *> raw_list, QMap<uint64_t, 
-		PolyNode> & poly_nodes, QString name, TrMapNet * osm_net, bool is_road);
+	// 'net': OSM_NET_ROAD, ...
+	bool addRawNodes(const uint32_t * slots, int n_nodes, int net, uint8_t dir);
+	// the nodes used by a net, built before the nets from 'm_degree'
+	bool createNodePool();
+	bool addNodeObj(TrMapList * node_map, const OsmPartNode_t & node);
+	// thread safe, the objects of the net are created in 'bindPart'
+	bool cutLink(const OsmRawWay_t & raw_way, OsmNetPart & part);
+	void appendPartNode(OsmNetPart & part, uint64_t id, uint32_t slot);
+	TrGeoPolygon * createPolygon(const uint32_t * slot, int first, int last);
+	void cutPart(OsmNetPart & part);
+	void bindPart(OsmNetPart & part, TrMapNet * osm_net);
+
+	// the raw ways are freed after the net is created
+	bool finalizeNet(QVector<OsmRawWay_t> & raw_list, int net,
+		QString name, TrMapNet * osm_net, bool is_road);
 
 	bool createNet(TrMapNet * osm_net, QString name);
+	// all nets at once, each one on a worker thread, 'net_ok' per net
+	bool createNets(const QVector<TrMapNet *> & nets, const QStringList & names,
+			QVector<bool> & net_ok);
 
 	int checkDir(const Way_t & way1, const Way_t & way2);
 	bool appendFacePoint(uint64_t id, TrMapFace & face);
 	bool appendFacePoints(const Way_t & way, TrMapFace & face, bool dir);
 
-#ifdef OSM_C_FILTER
-	void createRelFace(Rel_t & relation, Way_t * ways, uint64_t n_way);
-#endif
+	// TrMapFace objects of the multipolygon relations in 'face_list'
+	void createRelFaces();
 
+	// thread safe, the faces are appended in 'createFaceLists'
+	void resolveFacePart(OsmFacePart & part);
+	// all face layers in one pass over the ways
+	bool createFaceLists(const QVector<TrMapList *> & osm_lists, const QStringList & names);
 	bool createFaceList(TrMapList * osm_list, QString name);
 
 	TrMapList * createPoiMap(QString name);
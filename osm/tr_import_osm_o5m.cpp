@@ -0,0 +1,405 @@
+/******************************************************************
+ *
+ * @short	data import in OSM o5m format
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrImportOsmO5m
+ * superclass:	---
+ * modul:	tr_import_osm_o5m.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_import_osm_o5m.h"
+#include "tr_import_osm_rel.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qfile.h>
+
+#include <string.h>
+
+// dataset types
+#define O5M_NODE       0x10
+#define O5M_WAY        0x11
+#define O5M_RELATION   0x12
+#define O5M_HEADER     0xe0
+#define O5M_EOF        0xfe
+#define O5M_RESET      0xff
+
+TrImportOsmO5m::TrImportOsmO5m(const QString & name)
+	: m_filename(name)
+	, m_str_pos(0)
+	, m_ptr(nullptr)
+	, m_end(nullptr)
+	, m_ok(true)
+{
+	reset();
+}
+
+TrImportOsmO5m::~TrImportOsmO5m()
+{
+}
+
+QString TrImportOsmO5m::errorString() const
+{
+	return m_error;
+}
+
+void TrImportOsmO5m::reset()
+{
+	memset(m_str, 0x00, sizeof(m_str));
+	m_str_pos = 0;
+	m_node_id = 0;
+	m_way_id = 0;
+	m_rel_id = 0;
+	m_node_ref = 0;
+	m_rel_ref[0] = 0;
+	m_rel_ref[1] = 0;
+	m_rel_ref[2] = 0;
+	m_lon = 0;
+	m_lat = 0;
+	m_timestamp = 0;
+	m_changeset = 0;
+}
+
+uint64_t TrImportOsmO5m::readUnsigned()
+{
+	uint64_t ret = 0;
+	for(int shift = 0; shift < 64; shift += 7)
+	{
+		if(m_ptr >= m_end)
+			break;
+		uint8_t b = *m_ptr++;
+		ret |= static_cast<uint64_t>(b & 0x7f) << shift;
+		if(!(b & 0x80))
+			return ret;
+	}
+	m_ok = false;
+	return 0;
+}
+
+int64_t TrImportOsmO5m::readSigned()
+{
+	uint64_t val = readUnsigned();
+	// bit 0 is the sign
+	if(val & 1)
+		return -static_cast<int64_t>(val >> 1) - 1;
+	return static_cast<int64_t>(val >> 1);
+}
+
+// a string (pair) is given inline ("key\0value\0") or as
+// reference to one of the last 15000 inline strings
+bool TrImportOsmO5m::readString(O5mString_t & str, bool pair)
+{
+	uint64_t ref = readUnsigned();
+	if(!m_ok)
+		return false;
+	if(ref > 0)
+	{
+		if(ref > O5M_STR_TABLE)
+		{
+			m_ok = false;
+			return false;
+		}
+		str = m_str[(m_str_pos + O5M_STR_TABLE - ref) % O5M_STR_TABLE];
+		if(str.key.ptr == nullptr)
+		{
+			m_ok = false;
+			return false;
+		}
+		return true;
+	}
+
+	const char * act = reinterpret_cast<const char *>(m_ptr);
+	const char * end = reinterpret_cast<const char *>(m_end);
+	const char * zero = static_cast<const char *>(memchr(act, 0, end - act));
+	if(zero == nullptr)
+	{
+		m_ok = false;
+		return false;
+	}
+	str.key = osmView(act, static_cast<int32_t>(zero - act));
+	str.value = osmView(zero, 0);
+	act = zero + 1;
+	if(pair)
+	{
+		zero = static_cast<const char *>(memchr(act, 0, end - act));
+		if(zero == nullptr)
+		{
+			m_ok = false;
+			return false;
+		}
+		str.value = osmView(act, static_cast<int32_t>(zero - act));
+		act = zero + 1;
+	}
+	m_ptr = reinterpret_cast<const uint8_t *>(act);
+
+	if((str.key.len + str.value.len) <= O5M_STR_MAX_LEN)
+	{
+		m_str[m_str_pos] = str;
+		m_str_pos = (m_str_pos + 1) % O5M_STR_TABLE;
+	}
+	return true;
+}
+
+// version, timestamp, changeset, uid and user are not used
+void TrImportOsmO5m::skipVersion()
+{
+	if(readUnsigned() == 0)
+		return;
+	m_timestamp += readSigned();
+	if(m_timestamp == 0)
+		return;
+	m_changeset += readSigned();
+
+	// the uid is a number, it can contain a 0x00
+	uint64_t ref = readUnsigned();
+	if((!m_ok) || (ref > 0))
+		return;
+	const uint8_t * uid = m_ptr;
+	readUnsigned();
+	if((m_ptr >= m_end) || (*m_ptr != 0))
+	{
+		m_ok = false;
+		return;
+	}
+	O5mString_t str;
+	str.key = osmView(reinterpret_cast<const char *>(uid), static_cast<int32_t>(m_ptr - uid));
+	m_ptr++;
+	const uint8_t * user = m_ptr;
+	const uint8_t * zero = static_cast<const uint8_t *>(memchr(user, 0, m_end - user));
+	if(zero == nullptr)
+	{
+		m_ok = false;
+		return;
+	}
+	str.value = osmView(reinterpret_cast<const char *>(user), static_cast<int32_t>(zero - user));
+	m_ptr = zero + 1;
+	if((str.key.len + str.value.len) <= O5M_STR_MAX_LEN)
+	{
+		m_str[m_str_pos] = str;
+		m_str_pos = (m_str_pos + 1) % O5M_STR_TABLE;
+	}
+}
+
+void TrImportOsmO5m::readNode(TrImportOsmStream & sink, World_t & world)
+{
+	O5mString_t tag;
+
+	m_node_id += readSigned();
+	skipVersion();
+	// deleted node, only in change files
+	if(m_ptr >= m_end)
+		return;
+	m_lon += readSigned();
+	m_lat += readSigned();
+	if(!m_ok)
+		return;
+
+	sink.beginNode(static_cast<uint64_t>(m_node_id),
+			static_cast<int32_t>(m_lon), static_cast<int32_t>(m_lat));
+	while((m_ptr < m_end) && readString(tag, true))
+	{
+		sink.addTag(QString::fromUtf8(tag.key.ptr, tag.key.len),
+				QString::fromUtf8(tag.value.ptr, tag.value.len));
+	}
+	sink.endNode(world);
+}
+
+void TrImportOsmO5m::readWay(TrImportOsmStream & sink, World_t & world)
+{
+	O5mString_t tag;
+
+	m_way_id += readSigned();
+	skipVersion();
+	if(m_ptr >= m_end)
+		return;
+	uint64_t ref_size = readUnsigned();
+	if((!m_ok) || (ref_size > static_cast<uint64_t>(m_end - m_ptr)))
+	{
+		m_ok = false;
+		return;
+	}
+
+	sink.beginWay(static_cast<uint64_t>(m_way_id));
+	const uint8_t * ref_end = m_ptr + ref_size;
+	while((m_ptr < ref_end) && m_ok)
+	{
+		m_node_ref += readSigned();
+		sink.addNodeRef(static_cast<uint64_t>(m_node_ref));
+	}
+	while((m_ptr < m_end) && readString(tag, true))
+	{
+		sink.addTag(QString::fromUtf8(tag.key.ptr, tag.key.len),
+				QString::fromUtf8(tag.value.ptr, tag.value.len));
+	}
+	sink.endWay(world);
+}
+
+void TrImportOsmO5m::readRelation(TrImportOsmStream & sink)
+{
+	O5mString_t str;
+	TrImportOsmRel rel_read;
+	Relation rel;
+
+	m_rel_id += readSigned();
+	skipVersion();
+	if(m_ptr >= m_end)
+		return;
+	uint64_t ref_size = readUnsigned();
+	if((!m_ok) || (ref_size > static_cast<uint64_t>(m_end - m_ptr)))
+	{
+		m_ok = false;
+		return;
+	}
+
+	rel_read.beginRelation(static_cast<uint64_t>(m_rel_id), rel);
+	const uint8_t * ref_end = m_ptr + ref_size;
+	while((m_ptr < ref_end) && m_ok)
+	{
+		int64_t delta = readSigned();
+		// "1outer": type (0: node, 1: way, 2: relation) and role
+		if(!readString(str, false) || (str.key.len < 1))
+			break;
+		int type = str.key.ptr[0] - '0';
+		if((type < 0) || (type > 2))
+		{
+			m_ok = false;
+			break;
+		}
+		m_rel_ref[type] += delta;
+		if(type == 1)
+		{
+			rel_read.addWayMember(static_cast<uint64_t>(m_rel_ref[type]),
+					osmView(str.key.ptr + 1, str.key.len - 1), rel);
+		}
+	}
+	while((m_ptr < m_end) && readString(str, true))
+	{
+		rel_read.addTag(QString::fromUtf8(str.key.ptr, str.key.len),
+				QString::fromUtf8(str.value.ptr, str.value.len));
+	}
+	sink.endRelation(rel_read, rel);
+}
+
+bool TrImportOsmO5m::osmRead(TrImportOsmStream & sink, World_t & world)
+{
+	QFile file(m_filename);
+	QByteArray content;
+	const uint8_t * data = nullptr;
+
+	if (!file.open(QFile::ReadOnly))
+	{
+		m_error = file.errorString();
+		return false;
+	}
+	uchar * map = file.map(0, file.size());
+	if(map != nullptr)
+	{
+		data = map;
+	}
+	else
+	{
+		TR_WRN << "mapping failed, read file" << m_filename;
+		content = file.readAll();
+		data = reinterpret_cast<const uint8_t *>(content.constData());
+	}
+
+	const uint8_t * file_end = data + file.size();
+	const uint8_t * act = data;
+
+	if((act >= file_end) || (*act != O5M_RESET))
+	{
+		m_error = "no o5m file";
+		TR_ERR << m_error << m_filename;
+		return false;
+	}
+
+	reset();
+	m_ok = true;
+	sink.beginOsm(world);
+	while(act < file_end)
+	{
+		uint8_t type = *act++;
+		if(type == O5M_RESET)
+		{
+			reset();
+			continue;
+		}
+		if(type == O5M_EOF)
+			break;
+
+		m_ptr = act;
+		m_end = file_end;
+		uint64_t size = readUnsigned();
+		if((!m_ok) || (size > static_cast<uint64_t>(file_end - m_ptr)))
+		{
+			m_error = QString("invalid dataset at byte %1").arg(act - data);
+			break;
+		}
+		m_end = m_ptr + size;
+		act = m_end;
+
+		switch(type)
+		{
+		case O5M_NODE:
+			readNode(sink, world);
+			break;
+		case O5M_WAY:
+			readWay(sink, world);
+			break;
+		case O5M_RELATION:
+			readRelation(sink);
+			break;
+		case O5M_HEADER:
+			if((size != 4) || (memcmp(m_ptr, "o5m2", 4) != 0))
+			{
+				m_error = "only o5m2 is supported, no change files";
+				m_ok = false;
+			}
+			break;
+		default:
+			// bounding box, timestamp, sync, jump
+			break;
+		}
+		if(!m_ok)
+		{
+			if(m_error.isEmpty())
+				m_error = QString("invalid data at byte %1").arg(m_end - data);
+			break;
+		}
+	}
+	if(!m_error.isEmpty())
+	{
+		TR_ERR << m_error;
+		return false;
+	}
+	sink.endOsm(world);
+	return true;
+}
@@ -0,0 +1,108 @@
+/******************************************************************
+ *
+ * @short	data import in OSM o5m format
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrImportOsmO5m
+ * superclass:	---
+ * modul:	tr_import_osm_o5m.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_O5M_H
+#define TR_OSM_O5M_H
+
+#include <QtCore/qstring.h>
+
+#include "osm_load.h"
+#include "osm_view.h"
+
+#include "tr_import_osm_stream.h"
+
+// size of the string table, given by the format
+#define O5M_STR_TABLE   15000
+// longer strings are not stored in the table
+#define O5M_STR_MAX_LEN   250
+
+// entry of the string table, points into the mapped file
+typedef struct
+{
+	OsmView_t key;
+	OsmView_t value;
+}O5mString_t;
+
+// The o5m format can only be read in sequence (delta coding and
+// string references), but it needs no inflate and no text parsing.
+class TrImportOsmO5m
+{
+private:
+	QString m_filename;
+	QString m_error;
+
+	// string table as ring buffer
+	O5mString_t m_str[O5M_STR_TABLE];
+	int m_str_pos;
+
+	// delta values, set to 0 by a reset
+	int64_t m_node_id;
+	int64_t m_way_id;
+	int64_t m_rel_id;
+	int64_t m_node_ref;
+	// node, way, relation members
+	int64_t m_rel_ref[3];
+	int64_t m_lon;
+	int64_t m_lat;
+	int64_t m_timestamp;
+	int64_t m_changeset;
+
+	const uint8_t * m_ptr;
+	const uint8_t * m_end;
+	bool m_ok;
+
+	void reset();
+
+	uint64_t readUnsigned();
+	int64_t readSigned();
+	bool readString(O5mString_t & str, bool pair);
+	void skipVersion();
+
+	void readNode(TrImportOsmStream & sink, World_t & world);
+	void readWay(TrImportOsmStream & sink, World_t & world);
+	void readRelation(TrImportOsmStream & sink);
+
+public:
+	TrImportOsmO5m(const QString & name);
+	virtual ~TrImportOsmO5m();
+
+	bool osmRead(TrImportOsmStream & sink, World_t & world);
+
+	QString errorString() const;
+};
+
+#endif
@@ -0,0 +1,693 @@
+/******************************************************************
+ *
+ * @short	data import in OSM PBF format
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrImportOsmPbf
+ * superclass:	---
+ * modul:	tr_import_osm_pbf.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_import_osm_pbf.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qfile.h>
+
+#include <zlib.h>
+
+// limits of the OSM PBF specification
+#define PBF_MAX_HEADER_SIZE  (64 * 1024)
+#define PBF_MAX_BLOB_SIZE    (32 * 1024 * 1024)
+
+// protobuf wire types
+#define PBF_VARINT  0
+#define PBF_FIX64   1
+#define PBF_BYTES   2
+#define PBF_FIX32   5
+
+// reader for the protobuf wire format, stops on the first error
+class PbfBuf
+{
+private:
+	const uint8_t * m_ptr;
+	const uint8_t * m_end;
+	bool m_ok;
+
+public:
+	PbfBuf()
+		: m_ptr(nullptr)
+		, m_end(nullptr)
+		, m_ok(true)
+	{
+	}
+
+	PbfBuf(const char * data, size_t size)
+		: m_ptr(reinterpret_cast<const uint8_t *>(data))
+		, m_end(reinterpret_cast<const uint8_t *>(data) + size)
+		, m_ok(true)
+	{
+	}
+
+	bool atEnd() const
+	{
+		return ((!m_ok) || (m_ptr >= m_end));
+	}
+
+	bool ok() const
+	{
+		return m_ok;
+	}
+
+	const char * ptr() const
+	{
+		return reinterpret_cast<const char *>(m_ptr);
+	}
+
+	size_t size() const
+	{
+		return static_cast<size_t>(m_end - m_ptr);
+	}
+
+	uint64_t varint()
+	{
+		uint64_t ret = 0;
+		for(int shift = 0; shift < 64; shift += 7)
+		{
+			if(m_ptr >= m_end)
+				break;
+			uint8_t b = *m_ptr++;
+			ret |= static_cast<uint64_t>(b & 0x7f) << shift;
+			if(!(b & 0x80))
+				return ret;
+		}
+		m_ok = false;
+		return 0;
+	}
+
+	int64_t svarint()
+	{
+		uint64_t val = varint();
+		// zigzag
+		return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+	}
+
+	bool next(uint32_t & field, uint32_t & wire)
+	{
+		if(atEnd())
+			return false;
+		uint64_t key = varint();
+		field = static_cast<uint32_t>(key >> 3);
+		wire = static_cast<uint32_t>(key & 0x07);
+		return m_ok;
+	}
+
+	PbfBuf bytes()
+	{
+		uint64_t len = varint();
+		if((!m_ok) || (len > static_cast<uint64_t>(m_end - m_ptr)))
+		{
+			m_ok = false;
+			return PbfBuf();
+		}
+		PbfBuf ret(reinterpret_cast<const char *>(m_ptr), len);
+		m_ptr += len;
+		return ret;
+	}
+
+	void skip(uint32_t wire)
+	{
+		switch(wire)
+		{
+		case PBF_VARINT:
+			varint();
+			break;
+		case PBF_FIX64:
+			m_ptr += 8;
+			break;
+		case PBF_BYTES:
+			bytes();
+			break;
+		case PBF_FIX32:
+			m_ptr += 4;
+			break;
+		default:
+			m_ok = false;
+		}
+		if(m_ptr > m_end)
+			m_ok = false;
+	}
+};
+
+// nano degree -> fixed point of Point_t (1e-7 degree)
+static inline int32_t pbfCoor(int64_t offset, int64_t granularity, int64_t val)
+{
+	int64_t nano = offset + granularity * val;
+	return static_cast<int32_t>((nano >= 0) ? ((nano + 50) / 100) : ((nano - 50) / 100));
+}
+
+static void pbfTags(PbfBuf keys, PbfBuf vals, OsmBlock & block)
+{
+	while((!keys.atEnd()) && (!vals.atEnd()))
+	{
+		block.tags.append(static_cast<uint32_t>(keys.varint()));
+		block.tags.append(static_cast<uint32_t>(vals.varint()));
+	}
+}
+
+static void pbfNode(PbfBuf buf, int64_t granularity, int64_t lat_offset, int64_t lon_offset,
+		OsmBlock & block)
+{
+	uint32_t field;
+	uint32_t wire;
+	PbfBuf keys;
+	PbfBuf vals;
+	int64_t lat = 0;
+	int64_t lon = 0;
+	OsmBlockNode_t node;
+
+	node.id = 0;
+	while(buf.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_VARINT))
+			node.id = static_cast<uint64_t>(buf.svarint());
+		else if((field == 2) && (wire == PBF_BYTES))
+			keys = buf.bytes();
+		else if((field == 3) && (wire == PBF_BYTES))
+			vals = buf.bytes();
+		else if((field == 8) && (wire == PBF_VARINT))
+			lat = buf.svarint();
+		else if((field == 9) && (wire == PBF_VARINT))
+			lon = buf.svarint();
+		else
+			buf.skip(wire);
+	}
+	node.x = pbfCoor(lon_offset, granularity, lon);
+	node.y = pbfCoor(lat_offset, granularity, lat);
+	node.tag = block.tags.size() / 2;
+	pbfTags(keys, vals, block);
+	node.n_tag = block.tags.size() / 2 - node.tag;
+	block.nodes.append(node);
+}
+
+static void pbfDense(PbfBuf buf, int64_t granularity, int64_t lat_offset, int64_t lon_offset,
+		OsmBlock & block)
+{
+	uint32_t field;
+	uint32_t wire;
+	PbfBuf ids;
+	PbfBuf lats;
+	PbfBuf lons;
+	PbfBuf keys_vals;
+
+	while(buf.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_BYTES))
+			ids = buf.bytes();
+		else if((field == 8) && (wire == PBF_BYTES))
+			lats = buf.bytes();
+		else if((field == 9) && (wire == PBF_BYTES))
+			lons = buf.bytes();
+		else if((field == 10) && (wire == PBF_BYTES))
+			keys_vals = buf.bytes();
+		else
+			buf.skip(wire);
+	}
+
+	// all values are delta coded
+	int64_t id = 0;
+	int64_t lat = 0;
+	int64_t lon = 0;
+	while(!ids.atEnd())
+	{
+		OsmBlockNode_t node;
+
+		id += ids.svarint();
+		lat += lats.svarint();
+		lon += lons.svarint();
+		node.id = static_cast<uint64_t>(id);
+		node.x = pbfCoor(lon_offset, granularity, lon);
+		node.y = pbfCoor(lat_offset, granularity, lat);
+		node.tag = block.tags.size() / 2;
+		// key, value, ..., 0 for every node
+		while(!keys_vals.atEnd())
+		{
+			uint32_t key = static_cast<uint32_t>(keys_vals.varint());
+			if(key == 0)
+				break;
+			block.tags.append(key);
+			block.tags.append(static_cast<uint32_t>(keys_vals.varint()));
+		}
+		node.n_tag = block.tags.size() / 2 - node.tag;
+		block.nodes.append(node);
+	}
+}
+
+static void pbfWay(PbfBuf buf, OsmBlock & block)
+{
+	uint32_t field;
+	uint32_t wire;
+	PbfBuf keys;
+	PbfBuf vals;
+	PbfBuf refs;
+	OsmBlockWay_t way;
+
+	way.id = 0;
+	while(buf.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_VARINT))
+			way.id = buf.varint();
+		else if((field == 2) && (wire == PBF_BYTES))
+			keys = buf.bytes();
+		else if((field == 3) && (wire == PBF_BYTES))
+			vals = buf.bytes();
+		else if((field == 8) && (wire == PBF_BYTES))
+			refs = buf.bytes();
+		else
+			buf.skip(wire);
+	}
+	way.tag = block.tags.size() / 2;
+	pbfTags(keys, vals, block);
+	way.n_tag = block.tags.size() / 2 - way.tag;
+
+	int64_t ref = 0;
+	way.ref = block.refs.size();
+	while(!refs.atEnd())
+	{
+		ref += refs.svarint();
+		block.refs.append(static_cast<uint64_t>(ref));
+	}
+	way.n_ref = block.refs.size() - way.ref;
+	block.ways.append(way);
+}
+
+static void pbfRelation(PbfBuf buf, OsmBlock & block)
+{
+	uint32_t field;
+	uint32_t wire;
+	PbfBuf keys;
+	PbfBuf vals;
+	PbfBuf roles;
+	PbfBuf ids;
+	PbfBuf types;
+	OsmBlockRel_t rel;
+
+	rel.id = 0;
+	while(buf.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_VARINT))
+			rel.id = buf.varint();
+		else if((field == 2) && (wire == PBF_BYTES))
+			keys = buf.bytes();
+		else if((field == 3) && (wire == PBF_BYTES))
+			vals = buf.bytes();
+		else if((field == 8) && (wire == PBF_BYTES))
+			roles = buf.bytes();
+		else if((field == 9) && (wire == PBF_BYTES))
+			ids = buf.bytes();
+		else if((field == 10) && (wire == PBF_BYTES))
+			types = buf.bytes();
+		else
+			buf.skip(wire);
+	}
+	rel.tag = block.tags.size() / 2;
+	pbfTags(keys, vals, block);
+	rel.n_tag = block.tags.size() / 2 - rel.tag;
+
+	int64_t id = 0;
+	rel.mem = block.members.size();
+	while(!ids.atEnd())
+	{
+		OsmBlockMember_t member;
+
+		id += ids.svarint();
+		member.id = static_cast<uint64_t>(id);
+		member.role = static_cast<uint32_t>(roles.varint());
+		// 0: node, 1: way, 2: relation
+		member.type = static_cast<uint32_t>(types.varint());
+		block.members.append(member);
+	}
+	rel.n_mem = block.members.size() - rel.mem;
+	block.rels.append(rel);
+}
+
+static bool pbfGroup(PbfBuf buf, int64_t granularity, int64_t lat_offset, int64_t lon_offset,
+		OsmBlock & block)
+{
+	uint32_t field;
+	uint32_t wire;
+
+	while(buf.next(field, wire))
+	{
+		if(wire != PBF_BYTES)
+		{
+			buf.skip(wire);
+			continue;
+		}
+		PbfBuf elem = buf.bytes();
+		switch(field)
+		{
+		case 1:
+			pbfNode(elem, granularity, lat_offset, lon_offset, block);
+			break;
+		case 2:
+			pbfDense(elem, granularity, lat_offset, lon_offset, block);
+			break;
+		case 3:
+			pbfWay(elem, block);
+			break;
+		case 4:
+			pbfRelation(elem, block);
+			break;
+		default:
+			// changesets
+			break;
+		}
+	}
+	return buf.ok();
+}
+
+TrImportOsmPbf::TrImportOsmPbf(const QString & name)
+	: m_filename(name)
+{
+}
+
+TrImportOsmPbf::~TrImportOsmPbf()
+{
+}
+
+QString TrImportOsmPbf::errorString() const
+{
+	return m_error;
+}
+
+// static, called by the worker threads
+OsmBlock TrImportOsmPbf::decodeBlob(const OsmChunk_t & blob)
+{
+	OsmBlock block;
+
+	if(blob.raw_size > 0)
+	{
+		block.data.resize(blob.raw_size);
+		uLongf len = blob.raw_size;
+		int ret = uncompress(reinterpret_cast<Bytef *>(block.data.data()), &len,
+				reinterpret_cast<const Bytef *>(blob.data), blob.size);
+		if((ret != Z_OK) || (len != blob.raw_size))
+		{
+			block.error = QString("inflate error %1").arg(ret);
+			return block;
+		}
+	}
+	else
+	{
+		block.data = QByteArray::fromRawData(blob.data, blob.size);
+	}
+
+	// PrimitiveBlock, the offsets are behind the groups
+	PbfBuf buf(block.data.constData(), block.data.size());
+	PbfBuf strings;
+	QVector<PbfBuf> groups;
+	int64_t granularity = 100;
+	int64_t lat_offset = 0;
+	int64_t lon_offset = 0;
+	uint32_t field;
+	uint32_t wire;
+
+	while(buf.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_BYTES))
+			strings = buf.bytes();
+		else if((field == 2) && (wire == PBF_BYTES))
+			groups.append(buf.bytes());
+		else if((field == 17) && (wire == PBF_VARINT))
+			granularity = static_cast<int64_t>(buf.varint());
+		else if((field == 19) && (wire == PBF_VARINT))
+			lat_offset = static_cast<int64_t>(buf.varint());
+		else if((field == 20) && (wire == PBF_VARINT))
+			lon_offset = static_cast<int64_t>(buf.varint());
+		else
+			buf.skip(wire);
+	}
+	if(!buf.ok())
+	{
+		block.error = "PrimitiveBlock damaged";
+		return block;
+	}
+
+	while(strings.next(field, wire))
+	{
+		if((field == 1) && (wire == PBF_BYTES))
+		{
+			PbfBuf str = strings.bytes();
+			block.views.append(osmView(str.ptr(), static_cast<int32_t>(str.size())));
+		}
+		else
+			strings.skip(wire);
+	}
+
+	for(int i = 0; i < groups.size(); i++)
+	{
+		if(!pbfGroup(groups[i], granularity, lat_offset, lon_offset, block))
+		{
+			block.error = "PrimitiveGroup damaged";
+			return block;
+		}
+	}
+
+	// string indexes of the tags and roles
+	uint32_t n_view = static_cast<uint32_t>(block.views.size());
+	for(int i = 0; i < block.tags.size(); i++)
+	{
+		if(block.tags[i] >= n_view)
+		{
+			block.error = "string index out of range";
+			return block;
+		}
+	}
+	for(int i = 0; i < block.members.size(); i++)
+	{
+		if(block.members[i].role >= n_view)
+		{
+			block.error = "string index out of range";
+			return block;
+		}
+	}
+	// the key of each string once, the sink converts only the used values
+	block.keys.fill(OSM_TAG_NONE, block.views.size());
+	for(int i = 0; i < block.tags.size(); i += 2)
+		block.keys[block.tags[i]] = TrImportOsmStream::blockKey(block.views[block.tags[i]]);
+	block.ok = true;
+	return block;
+}
+
+bool TrImportOsmPbf::checkHeader(const OsmChunk_t & blob)
+{
+	QByteArray raw;
+	PbfBuf buf;
+	uint32_t field;
+	uint32_t wire;
+
+	if(blob.raw_size > 0)
+	{
+		raw.resize(blob.raw_size);
+		uLongf len = blob.raw_size;
+		if(uncompress(reinterpret_cast<Bytef *>(raw.data()), &len,
+				reinterpret_cast<const Bytef *>(blob.data), blob.size) != Z_OK)
+		{
+			m_error = "inflate error in OSMHeader";
+			return false;
+		}
+		buf = PbfBuf(raw.constData(), len);
+	}
+	else
+	{
+		buf = PbfBuf(blob.data, blob.size);
+	}
+
+	// HeaderBlock: required_features
+	while(buf.next(field, wire))
+	{
+		if((field == 4) && (wire == PBF_BYTES))
+		{
+			PbfBuf str = buf.bytes();
+			OsmView_t feature = osmView(str.ptr(), static_cast<int32_t>(str.size()));
+			if((!osmViewIs(feature, "OsmSchema-V0.6")) && (!osmViewIs(feature, "DenseNodes")))
+			{
+				m_error = "unsupported feature: " + QString::fromUtf8(feature.ptr, feature.len);
+				return false;
+			}
+		}
+		else
+			buf.skip(wire);
+	}
+	return buf.ok();
+}
+
+bool TrImportOsmPbf::readBlobs(const char * data, size_t size, QVector<OsmChunk_t> & blobs)
+{
+	size_t pos = 0;
+
+	while(pos < size)
+	{
+		if(pos + 4 > size)
+		{
+			m_error = QString("truncated file at byte %1").arg(pos);
+			return false;
+		}
+		const uint8_t * len_ptr = reinterpret_cast<const uint8_t *>(data + pos);
+		uint32_t header_size = (static_cast<uint32_t>(len_ptr[0]) << 24) |
+				(static_cast<uint32_t>(len_ptr[1]) << 16) |
+				(static_cast<uint32_t>(len_ptr[2]) << 8) |
+				static_cast<uint32_t>(len_ptr[3]);
+		pos += 4;
+		if((header_size > PBF_MAX_HEADER_SIZE) || (pos + header_size > size))
+		{
+			m_error = QString("invalid BlobHeader at byte %1").arg(pos);
+			return false;
+		}
+
+		// BlobHeader: type, datasize
+		PbfBuf header(data + pos, header_size);
+		OsmView_t type = osmView(nullptr, 0);
+		uint64_t data_size = 0;
+		uint32_t field;
+		uint32_t wire;
+		while(header.next(field, wire))
+		{
+			if((field == 1) && (wire == PBF_BYTES))
+			{
+				PbfBuf str = header.bytes();
+				type = osmView(str.ptr(), static_cast<int32_t>(str.size()));
+			}
+			else if((field == 3) && (wire == PBF_VARINT))
+				data_size = header.varint();
+			else
+				header.skip(wire);
+		}
+		pos += header_size;
+		if((!header.ok()) || (data_size > PBF_MAX_BLOB_SIZE) || (pos + data_size > size))
+		{
+			m_error = QString("invalid Blob at byte %1").arg(pos);
+			return false;
+		}
+
+		// Blob: raw or zlib_data
+		PbfBuf buf(data + pos, data_size);
+		OsmChunk_t blob;
+		uint32_t raw_size = 0;
+		bool zlib = false;
+		blob.data = nullptr;
+		blob.size = 0;
+		while(buf.next(field, wire))
+		{
+			if(((field == 1) || (field == 3)) && (wire == PBF_BYTES))
+			{
+				PbfBuf content = buf.bytes();
+				blob.data = content.ptr();
+				blob.size = static_cast<uint32_t>(content.size());
+				zlib = (field == 3);
+			}
+			else if((field == 2) && (wire == PBF_VARINT))
+				raw_size = static_cast<uint32_t>(buf.varint());
+			else if(wire == PBF_BYTES)
+			{
+				// lzma, lz4, zstd
+				m_error = QString("unsupported compression %1 at byte %2").arg(field).arg(pos);
+				return false;
+			}
+			else
+				buf.skip(wire);
+		}
+		pos += data_size;
+		if((!buf.ok()) || (blob.data == nullptr) || (zlib && (raw_size == 0)) ||
+				(raw_size > PBF_MAX_BLOB_SIZE))
+		{
+			m_error = QString("invalid Blob before byte %1").arg(pos);
+			return false;
+		}
+		blob.raw_size = (zlib ? raw_size : 0);
+
+		if(osmViewIs(type, "OSMHeader"))
+		{
+			if(!checkHeader(blob))
+				return false;
+		}
+		else if(osmViewIs(type, "OSMData"))
+		{
+			blobs.append(blob);
+		}
+		else
+		{
+			TR_WRN << "unknown blob" << QByteArray(type.ptr, type.len);
+		}
+	}
+	return true;
+}
+
+bool TrImportOsmPbf::osmRead(TrImportOsmStream & sink, World_t & world)
+{
+	QFile file(m_filename);
+	QByteArray content;
+	const char * data = nullptr;
+
+	if (!file.open(QFile::ReadOnly))
+	{
+		m_error = file.errorString();
+		return false;
+	}
+	uchar * map = file.map(0, file.size());
+	if(map != nullptr)
+	{
+		data = reinterpret_cast<const char *>(map);
+	}
+	else
+	{
+		TR_WRN << "mapping failed, read file" << m_filename;
+		content = file.readAll();
+		data = content.constData();
+	}
+
+	QVector<OsmChunk_t> blobs;
+	if(!readBlobs(data, static_cast<size_t>(file.size()), blobs))
+	{
+		TR_ERR << m_error;
+		return false;
+	}
+	TR_INF << "blobs:" << blobs.size();
+
+	sink.beginOsm(world);
+	if(!sink.addBlocks(blobs, &TrImportOsmPbf::decodeBlob, world, m_error))
+	{
+		TR_ERR << m_error;
+		return false;
+	}
+	sink.endOsm(world);
+	return true;
+}
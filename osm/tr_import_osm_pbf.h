@@ -0,0 +1,72 @@
+/******************************************************************
+ *
+ * @short	data import in OSM PBF format
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrImportOsmPbf
+ * superclass:	---
+ * modul:	tr_import_osm_pbf.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_PBF_H
+#define TR_OSM_PBF_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include "osm_block.h"
+#include "osm_load.h"
+
+#include "tr_import_osm_stream.h"
+
+// The blobs are inflated and decoded on all cores, the results are
+// given to the TrImportOsmStream in file order, so the result is the
+// same as for the XML file.
+class TrImportOsmPbf
+{
+private:
+	QString m_filename;
+	QString m_error;
+
+	bool readBlobs(const char * data, size_t size, QVector<OsmChunk_t> & blobs);
+	bool checkHeader(const OsmChunk_t & blob);
+
+public:
+	TrImportOsmPbf(const QString & name);
+	virtual ~TrImportOsmPbf();
+
+	bool osmRead(TrImportOsmStream & sink, World_t & world);
+
+	static OsmBlock decodeBlob(const OsmChunk_t & blob);
+
+	QString errorString() const;
+};
+
+#endif
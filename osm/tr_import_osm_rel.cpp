@@ -42,8 +42,12 @@
 
 #include <tr_prof_class_def.h>
 
+#include "osm_num.h"
+#include "osm_tag_hash.h"
+
 Relation::Relation()
-        : m_flags(0)
+        : m_id(0)
+        , m_flags(0)
 {
 }
 
@@ -69,21 +73,41 @@ int Relation::isMultiPolyRing()
 	return count_out;
 }
 
-void Relation::resetPolyRing(QMap<uint64_t, Way_t> & waylist)
+void Relation::resetPolyRing(Way_t * ways, size_t n_way)
 {
 	if(!(m_flags & FLAG_MULTI_POLY))
 		return;
 
 	for (int i = 0; i < m_members.size(); ++i)
 	{
-		if(waylist.contains(m_members[i].id))
+		Way_t * way = TrImportOsmRel::findWay(ways, n_way, m_members[i].id);
+		if(way != nullptr)
 		{
 			if(m_members[i].flags & REL_MEM_ROLE_OUT)
-				waylist[m_members[i].id].type &= ~FLAG_FEATURE_AERA;
+				way->type &= ~FLAG_FEATURE_AERA;
 		}
 	}
 }
 
+// static, 'ways' is sorted by id
+Way_t * TrImportOsmRel::findWay(Way_t * ways, size_t n_way, uint64_t id)
+{
+	size_t pos1 = 0;
+	size_t pos2 = n_way;
+
+	while(pos1 < pos2)
+	{
+		size_t mid = pos1 + ((pos2 - pos1) >> 1);
+		if(ways[mid].id < id)
+			pos1 = mid + 1;
+		else
+			pos2 = mid;
+	}
+	if((pos1 < n_way) && (ways[pos1].id == id))
+		return &ways[pos1];
+	return nullptr;
+}
+
 TrImportOsmRel::TrImportOsmRel()
 	: m_id(0)
 {
@@ -93,7 +117,7 @@ TrImportOsmRel::~TrImportOsmRel()
 {
 }
 
-bool TrImportOsmRel::osmRelationRead(QXmlStreamReader & xml, QMap<uint64_t, Way_t> & waylist, Relation & rel)
+bool TrImportOsmRel::osmRelationRead(QXmlStreamReader & xml, Way_t * ways, size_t n_way, Relation & rel)
 		//QMap<uint64_t, Rel_t> & rellist)
 {
 	rel.m_flags = 0;
@@ -150,11 +174,11 @@ bool TrImportOsmRel::osmRelationRead(QXmlStreamReader & xml, QMap<uint64_t, Way_
 			{
 				TR_WRN << xml.name() << "not allowed";
 				//TR_INF << "close way" << m_tags;
-				//closeWay(world.m_name_map, world.act_name_idx);
+				//closeWay(world.m_names);
 			}
 			if(xml.name() == "relation")
 			{
-				closeRelation(waylist, rel);
+				closeRelation(ways, n_way, rel);
 				return true;
 			}
 			if(xml.name() == "tag")
@@ -174,14 +198,64 @@ bool TrImportOsmRel::osmRelationRead(QXmlStreamReader & xml, QMap<uint64_t, Way_
 	return false;
 }
 
+// mapped file version of the reader above
+bool TrImportOsmRel::osmRelationRead(TrOsmXmlScan & xml, Way_t * ways, size_t n_way, Relation & rel)
+{
+	uint64_t id = 0;
+	OsmView_t value;
+
+	rel.m_flags = 0;
+	rel.m_members.clear();
+	m_tags.clear();
+
+	xml.attribute("id", value);
+	if(osmParseId(value.ptr, value.len, id))
+	{
+		m_id = id;
+	}
+
+	while (!xml.atEnd())
+	{
+		xml.readNext();
+		if(xml.isStartElement())
+		{
+			const OsmView_t & name = xml.name();
+			if(osmViewIs(name, "tag"))
+			{
+				readTag(xml);
+			}
+			else if(osmViewIs(name, "member"))
+			{
+				readMember(xml, rel);
+			}
+			else
+			{
+				TR_WRN << QByteArray(name.ptr, name.len) << "not allowed";
+			}
+		}
+		if(xml.isEndElement())
+		{
+			if(osmViewIs(xml.name(), "relation"))
+			{
+				closeRelation(ways, n_way, rel);
+				return true;
+			}
+		}
+	}
+	if (xml.hasError())
+	{
+		TR_ERR << xml.errorString();
+	}
+	return false;
+}
+
 void TrImportOsmRel::readRelation(const QXmlStreamAttributes &attributes, Relation & rel)
 {
-	bool ok;
+	uint64_t id = 0;
 
 	rel.m_members.clear();
 	m_tags.clear();
-	int64_t id = attributes.value("id").toULongLong(&ok);
-	if(ok)
+	if(osmParseId(attributes.value("id"), id))
 	{
 		m_id = id;
 	}
@@ -190,8 +264,6 @@ void TrImportOsmRel::readRelation(const QXmlStreamAttributes &attributes, Relati
 
 void TrImportOsmRel::readMember(const QXmlStreamAttributes &attributes, Relation & rel)
 {
-	bool ok;
-
 	QString type = attributes.value("type").toString();
 	if(type != "way")
 		return;
@@ -199,8 +271,7 @@ void TrImportOsmRel::readMember(const QXmlStreamAttributes &attributes, Relation
 	RelMember_t member;
 	member.flags = 0;
 	//m_id
-	member.id = attributes.value("ref").toULongLong(&ok);
-	if(!ok)
+	if(!osmParseId(attributes.value("ref"), member.id))
 	{
 		member.id = -1;
 		return;
@@ -218,8 +289,19 @@ void TrImportOsmRel::readMember(const QXmlStreamAttributes &attributes, Relation
 
 void TrImportOsmRel::readTag(const QXmlStreamAttributes &attributes)
 {
-	QString key = attributes.value("k").toString();
-	QString value = attributes.value("v").toString();
+	addTag(attributes.value("k").toString(), attributes.value("v").toString());
+}
+
+void TrImportOsmRel::beginRelation(uint64_t id, Relation & rel)
+{
+	rel.m_flags = 0;
+	rel.m_members.clear();
+	m_tags.clear();
+	m_id = id;
+}
+
+void TrImportOsmRel::addTag(const QString & key, const QString & value)
+{
 	if(m_tags.contains(key))
 	{
 		TR_WRN << "double use: " << key << value;
@@ -230,9 +312,50 @@ void TrImportOsmRel::readTag(const QXmlStreamAttributes &attributes)
 	}
 }
 
-void TrImportOsmRel::closeRelation(QMap<uint64_t, Way_t> & waylist, Relation & rel)
+void TrImportOsmRel::readMember(const TrOsmXmlScan & scan, Relation & rel)
+{
+	OsmView_t value;
+
+	if(!scan.attribute("type", value) || !osmViewIs(value, "way"))
+		return;
+
+	uint64_t id = 0;
+	scan.attribute("ref", value);
+	if(!osmParseId(value.ptr, value.len, id))
+	{
+		return;
+	}
+
+	scan.attribute("role", value);
+	addWayMember(id, value, rel);
+}
+
+void TrImportOsmRel::addWayMember(uint64_t id, const OsmView_t & role, Relation & rel)
+{
+	RelMember_t member;
+	member.flags = 0;
+	member.id = id;
+	if(osmViewIs(role, "outer"))
+		member.flags |= REL_MEM_ROLE_OUT;
+	if(osmViewIs(role, "inner"))
+		member.flags |= REL_MEM_ROLE_IN;
+	rel.m_members.append(member);
+}
+
+void TrImportOsmRel::readTag(const TrOsmXmlScan & scan)
+{
+	OsmView_t key;
+	OsmView_t value;
+	if(!scan.attribute("k", key) || !scan.attribute("v", value))
+		return;
+
+	addTag(TrOsmXmlScan::toString(key), TrOsmXmlScan::toString(value));
+}
+
+void TrImportOsmRel::closeRelation(Way_t * ways, size_t n_way, Relation & rel)
 {
         rel.m_flags = 0;
+	rel.m_id = static_cast<uint64_t>(m_id);
 
 	if(m_tags.contains("type"))
 	{
@@ -244,7 +367,7 @@ void TrImportOsmRel::closeRelation(QMap<uint64_t, Way_t> & waylist, Relation & r
 
 	if(rel.m_flags & FLAG_MULTI_POLY)
 	{
-		handleMultiPoly(waylist, rel);
+		handleMultiPoly(ways, n_way, rel);
 	}
 	if(rel.m_flags & FLAG_ROUTE)
 	{
@@ -256,7 +379,7 @@ void TrImportOsmRel::closeRelation(QMap<uint64_t, Way_t> & waylist, Relation & r
 	//m_members.clear();
 }
 
-bool TrImportOsmRel::handleMultiPoly(QMap<uint64_t, Way_t> & waylist, Relation & rel)
+bool TrImportOsmRel::handleMultiPoly(Way_t * ways, size_t n_way, Relation & rel)
 {
 	uint64_t type = 0;
 
@@ -284,33 +407,30 @@ bool TrImportOsmRel::handleMultiPoly(QMap<uint64_t, Way_t> & waylist, Relation &
 	// TODO: remove this - do it this in "tr_import_osm" for both filters
 	for (int i = 0; i < rel.m_members.size(); ++i)
 	{
+		Way_t * way = findWay(ways, n_way, rel.m_members[i].id);
+		if(way == nullptr)
+			continue;
 		if(rel.m_flags & TYPE_BUILDING)
 		{
-			if(waylist.contains(rel.m_members[i].id))
+			//TR_INF << HEX << rel.m_flags << way->type;
+			way->type = rel.m_flags;
+			if(rel.m_members[i].flags & REL_MEM_ROLE_IN)
 			{
-                //TR_INF << HEX << rel.m_flags << waylist[rel.m_members[i].id].type;
-				waylist[rel.m_members[i].id].type = rel.m_flags;
-				if(rel.m_members[i].flags & REL_MEM_ROLE_IN)
-				{
-					waylist[rel.m_members[i].id].type &= 0xfffffffffffffff0;
-					waylist[rel.m_members[i].id].type |= 0x0000000000000005;
-				}
+				way->type &= 0xfffffffffffffff0;
+				way->type |= 0x0000000000000005;
 			}
 		}
 		if(rel.m_flags & TYPE_NATURAL)
 		{
-			if(waylist.contains(rel.m_members[i].id))
+			//TR_INF << rel.m_members[i].id;
+			way->type = rel.m_flags;
+			if(rel.m_members[i].flags & REL_MEM_ROLE_IN)
 			{
-				//TR_INF << rel.m_members[i].id;
-				waylist[rel.m_members[i].id].type = rel.m_flags;
-				if(rel.m_members[i].flags & REL_MEM_ROLE_IN)
-				{
-					uint64_t cl = waylist[rel.m_members[i].id].type & 0x000000000000000ff;
-					if(!cl)
-						cl = 0x0000000000000003;
-					waylist[rel.m_members[i].id].type &= 0xfffffffffffffff0;
-					waylist[rel.m_members[i].id].type |= cl;
-				}
+				uint64_t cl = way->type & 0x000000000000000ff;
+				if(!cl)
+					cl = 0x0000000000000003;
+				way->type &= 0xfffffffffffffff0;
+				way->type |= cl;
 			}
 		}
 	}
@@ -325,184 +445,128 @@ bool TrImportOsmRel::handleMultiPoly(QMap<uint64_t, Way_t> & waylist, Relation &
 <tag k='entrance' v='yes' />
 */
 
-uint64_t TrImportOsmRel::getBarrierClass(const QString & value)
+static constexpr OsmTagEntry s_barrier_tags[] =
 {
-	if(value == "guard_rail")
-		return 1;
+	{"guard_rail", 1},
+	{"gate",       FLAG_FEATURE_NODE | 2},
+	{"bollard",    FLAG_FEATURE_NODE | 3},
+	{"entrance",   FLAG_FEATURE_NODE | 2},
+};
+OSM_TAG_TABLE(s_barrier, 8, 0x811C9DC6U)
 
-	//TR_INF << value;
-	if(value == "gate")
-		return (FLAG_FEATURE_NODE | 2);
-	if(value == "bollard")
-		return (FLAG_FEATURE_NODE | 3);
-	if(value == "entrance")
-		return (FLAG_FEATURE_NODE | 2);
-	return 0;
+uint64_t TrImportOsmRel::getBarrierClass(const QString & value)
+{
+	uint64_t code = 0;
+	osmTagFind(s_barrier_tags, s_barrier_slots, s_barrier_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_building_tags[] =
+{
+	{"yes",                BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"house",              BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"bungalow",           BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"terrace",            BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"detached",           BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"semidetached_house", BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"residential",        BUILDING_APAR | FLAG_FEATURE_AERA},
+	{"apartments",         BUILDING_APAR | FLAG_FEATURE_AERA},
+	{"dormitory",          BUILDING_APAR | FLAG_FEATURE_AERA},
+	{"retail",             BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"office",             BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"commercial",         BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"warehouse",          BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"roof",               BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"bridge",             BUILDING_SERVICE | FLAG_FEATURE_AERA},
+	{"kiosk",              BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"church",             BUILDING_REL | FLAG_FEATURE_AERA},
+	{"chapel",             BUILDING_REL | FLAG_FEATURE_AERA},
+	{"public",             BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"civic",              BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"school",             BUILDING_LEARN | FLAG_FEATURE_AERA},
+	{"hospital",           BUILDING_MEDI | FLAG_FEATURE_AERA},
+	{"fire_station",       BUILDING_SERVICE | FLAG_FEATURE_AERA},
+	{"kindergarten",       BUILDING_LEARN | FLAG_FEATURE_AERA},
+	{"industrial",         BUILDING_INDUST | FLAG_FEATURE_AERA},
+	{"farm",               BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"farm_auxiliary",     BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"barn",               BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"cowshed",            BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"stable",             BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"allotment_house",    BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"hut",                BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"sports_centre",      BUILDING_SERVICE | FLAG_FEATURE_AERA},
+	{"greenhouse",         BUILDING_INDUST | FLAG_FEATURE_AERA},
+	{"garage",             BUILDING_CAR | FLAG_FEATURE_AERA},
+	{"garages",            BUILDING_CAR | FLAG_FEATURE_AERA},
+	{"carport",            BUILDING_CAR | FLAG_FEATURE_AERA},
+	{"parking",            BUILDING_CAR | FLAG_FEATURE_AERA},
+	{"hotel",              BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"government",         BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"museum",             BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"university",         BUILDING_LEARN | FLAG_FEATURE_AERA},
+	{"ruins",              BUILDING_RUINS | FLAG_FEATURE_AERA},	// TODO: new building class?
+	{"shed",               BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"guardhouse",         BUILDING_SERVICE | FLAG_FEATURE_AERA},
+	{"service",            BUILDING_SERVICE | FLAG_FEATURE_AERA},
+	{"chalet",             BUILDING_HOUSE | FLAG_FEATURE_AERA},
+	{"sports_hall",        BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"clinic",             BUILDING_PUBLIC | FLAG_FEATURE_AERA},
+	{"water_tower",        BUILDING_SERVICE | FLAG_FEATURE_AERA},
+};
+OSM_TAG_TABLE(s_building, 128, 0x811DB6C5U)
+
 uint64_t TrImportOsmRel::getBuildingClass(const QString & value)
 {
-	if(value == "yes")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "house")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "bungalow")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "terrace")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "detached")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "semidetached_house")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "residential")
-		return (BUILDING_APAR | FLAG_FEATURE_AERA);
-	if(value == "apartments")
-		return (BUILDING_APAR | FLAG_FEATURE_AERA);
-	if(value == "dormitory")
-		return (BUILDING_APAR | FLAG_FEATURE_AERA);
-	if(value == "retail")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "office")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "commercial")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "warehouse")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "roof")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "bridge")
-		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-	if(value == "kiosk")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "church")
-		return (BUILDING_REL | FLAG_FEATURE_AERA);
-	if(value == "chapel")
-		return (BUILDING_REL | FLAG_FEATURE_AERA);
-	if(value == "public")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "civic")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "school")
-		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
-	if(value == "hospital")
-		return (BUILDING_MEDI | FLAG_FEATURE_AERA);
-	if(value == "fire_station")
-		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-	if(value == "kindergarten")
-		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
-	if(value == "industrial")
-		return (BUILDING_INDUST | FLAG_FEATURE_AERA);
-	if(value == "farm")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "farm_auxiliary")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "barn")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "cowshed")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "stable")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-    if(value == "allotment_house")
-        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-    if(value == "hut")
-        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-    if(value == "sports_centre")
-        return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-    if(value == "greenhouse")
-    {
-        return (BUILDING_INDUST | FLAG_FEATURE_AERA);
-    }
-    if(value == "garage")
-		return (BUILDING_CAR | FLAG_FEATURE_AERA);
-	if(value == "garages")
-		return (BUILDING_CAR | FLAG_FEATURE_AERA);
-	if(value == "carport")
-		return (BUILDING_CAR | FLAG_FEATURE_AERA);
-	if(value == "parking")
-		return (BUILDING_CAR | FLAG_FEATURE_AERA);
-	if(value == "hotel")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "government")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "museum")
-		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-	if(value == "university")
-		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
-	if(value == "ruins")		// TODO: new building class?
-		return (BUILDING_RUINS | FLAG_FEATURE_AERA);
-	if(value == "shed")
-		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-	if(value == "guardhouse")
-		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-	if(value == "service")
-		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-    if(value == "chalet")
-    {
-        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
-    }
-    if(value == "sports_hall")
-    {
-        return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-    }
-    if(value == "clinic")
-    {
-        return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
-    }
-    if(value == "water_tower")
-    {
-        return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
-    }
-    return (0x0007 | FLAG_FEATURE_AERA);
+	uint64_t code = (0x0007 | FLAG_FEATURE_AERA);
+	osmTagFind(s_building_tags, s_building_slots, s_building_seed, value, code);
+	return code;
 }
 
 // TODO:
 // <tag k='craft' v='shoemaker; locksmith' />
 //<tag k='railway' v='stop' />
 
+static constexpr OsmTagEntry s_highway_point_tags[] =
+{
+	{"level_crossing",  1 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"crossing",        1 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"street_lamp",     2},
+	{"traffic_signals", 7 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"bus_stop",        8 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"turning_circle",  6 | FLAG_FEATURE_NODE | TYPE_ROAD},
+};
+OSM_TAG_TABLE(s_highway_point, 16, 0x811C9DC8U)
+
 uint64_t TrImportOsmRel::getHighwayPointClass(const QString & value)
 {
-	if(value == "level_crossing")
-		return (1 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "crossing")
-		return (1 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "street_lamp")
-		return 2;
-	if(value == "traffic_signals")
-		return (7 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "bus_stop")
-		return (8 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "turning_circle")
-		return (6 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_highway_point_tags, s_highway_point_slots, s_highway_point_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_railway_point_tags[] =
+{
+	{"milestone",           1},
+	{"switch",              1},
+	{"level_crossing",      1},
+	{"crossing",            1},
+	{"railway_crossing",    1},
+	{"tram_crossing",       1},
+	{"tram_level_crossing", 1},
+	{"buffer_stop",         1},
+	{"stop",                8 | FLAG_FEATURE_NODE | TYPE_RAIL},
+	{"tram_stop",           8 | FLAG_FEATURE_NODE | TYPE_RAIL},
+	{"station",             8 | FLAG_FEATURE_NODE | TYPE_RAIL},
+	{"signal",              7 | FLAG_FEATURE_NODE | TYPE_RAIL},
+};
+OSM_TAG_TABLE(s_railway_point, 32, 0x811C9DC6U)
+
 uint64_t TrImportOsmRel::getRailwayPointClass(const QString & value)
 {
-	if(value == "milestone")
-		return 1;
-	if(value == "switch")
-		return 1;
-	if(value == "level_crossing")
-		return 1;
-	if(value == "crossing")
-		return 1;
-	if(value == "railway_crossing")
-		return 1;
-	if(value == "tram_crossing")
-		return 1;
-	if(value == "tram_level_crossing")
-		return 1;
-	if(value == "buffer_stop")
-		return 1;
-	if(value == "stop")
-		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
-	if(value == "tram_stop")
-		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
-	if(value == "station")
-		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
-	if(value == "signal")
-		return (7 | FLAG_FEATURE_NODE | TYPE_RAIL);
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_railway_point_tags, s_railway_point_slots, s_railway_point_seed, value, code);
+	return code;
 }
 
 //<tag k='natural' v='tree' />
@@ -513,165 +577,136 @@ uint64_t TrImportOsmRel::getRailwayPointClass(const QString & value)
 	return 0;
 }*/
 
+static constexpr OsmTagEntry s_amenity_tags[] =
+{
+	{"bench",            1},
+	{"waste_basket",     1},
+	{"recycling",        1},
+	{"fountain",         1},
+	{"hunting_stand",    1},
+	{"parking",          2 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"bicycle_parking",  2 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"parking_entrance", 2 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"vending_machine",  2 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"restaurant",       1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"cafe",             1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"bar",              1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"pub",              1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"fast_food",        1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},	// POI
+	{"canteen",          1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"doctors",          5 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"veterinary",       5 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"dentist",          5 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"pharmacy",         5 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"post_box",         6 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"kindergarten",     6 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"place_of_worship", 3 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"shelter",          4 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"fuel",             5 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"charging_station", 6 | FLAG_FEATURE_NODE | TYPE_ROAD},
+	{"taxi",             5 | FLAG_FEATURE_NODE | TYPE_ROAD},
+};
+OSM_TAG_TABLE(s_amenity, 64, 0x811C9DD9U)
+
 uint64_t TrImportOsmRel::getAmenityClass(const QString & value)
 {
-	//TR_INF << value;
-	if(value == "bench")
-		return (1);
-	if(value == "waste_basket")
-		return (1);
-	if(value == "recycling")
-		return (1);
-	if(value == "fountain")
-		return (1);
-	if(value == "hunting_stand")
-		return (1);
-	if(value == "parking")
-		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "bicycle_parking")
-		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "parking_entrance")
-		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "vending_machine")
-		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "restaurant")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "cafe")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "bar")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "pub")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "fast_food")	// POI
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "canteen")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "doctors")
-		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "veterinary")
-		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "dentist")
-		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "pharmacy")
-		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "post_box")
-		return (6 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "kindergarten")
-		return (6 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "place_of_worship")
-		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "shelter")
-		return (4 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "fuel")
-		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "charging_station")
-		return (6 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	if(value == "taxi")
-		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_amenity_tags, s_amenity_slots, s_amenity_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_shop_tags[] =
+{
+	{"vacant",      1},
+	{"kiosk",       1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"supermarket", 2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"convenience", 2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"beverages",   2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"wine",        2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"bakery",      2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"butcher",     2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"florist",     1 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"beauty",      3 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"laundry",     3 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"hairdresser", 3 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"electronics", 4 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"clothes",     2 | FLAG_FEATURE_NODE | TYPE_PUBLIC},
+	{"car_repair",  5 | FLAG_FEATURE_NODE | TYPE_ROAD},
+};
+OSM_TAG_TABLE(s_shop, 32, 0x811C9DDAU)
+
 uint64_t TrImportOsmRel::getShopClass(const QString & value)
 {
-	if(value == "vacant")
-		return 1;
-	//shop' v='kiosk
-	if(value == "kiosk")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "supermarket")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "convenience")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "beverages")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "wine")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "bakery")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "butcher")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "florist")
-		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "beauty")
-		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "laundry")
-		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "hairdresser")
-		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "electronics")
-		return (4 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "clothes")
-		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
-	if(value == "car_repair")
-		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
-
-	//"bicycle"
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_shop_tags, s_shop_slots, s_shop_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_landuse_tags[] =
+{
+	{"forest",            LANDUSE_WOOD  | FLAG_FEATURE_AERA},
+	{"grass",             LANDUSE_GRASS | FLAG_FEATURE_AERA},	// secondary layer
+	{"recreation_ground", LANDUSE_GRASS | FLAG_FEATURE_AERA},
+	{"meadow",            LANDUSE_GRASS | FLAG_FEATURE_AERA},
+	{"village_green",     LANDUSE_BUSHES | FLAG_FEATURE_AERA},
+	{"farmland",          LANDUSE_BUSHES | FLAG_FEATURE_AERA},
+	{"commercial",        LANDUSE_MIXED | FLAG_FEATURE_AERA},	// base layer?
+	{"residential",       LANDUSE_RESIDENTIAL | FLAG_FEATURE_AERA},	// base layer
+	{"construction",      LANDUSE_INDUSTRIAL | FLAG_FEATURE_AERA},	// secondary layer?
+};
+OSM_TAG_TABLE(s_landuse, 32, 0x811C9DC7U)
+
 uint64_t TrImportOsmRel::getLanduseClass(const QString & value)
 {
-	if(value == "forest")
-		return (LANDUSE_WOOD  | FLAG_FEATURE_AERA);
-	if(value == "grass")            // secondary layer
-		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
-	if(value == "recreation_ground")
-		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
-	if(value == "meadow")
-		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
-	if(value == "village_green")
-		return (LANDUSE_BUSHES | FLAG_FEATURE_AERA);
-	if(value == "farmland")
-		return (LANDUSE_BUSHES | FLAG_FEATURE_AERA);
-	if(value == "commercial")       // base layer?
-		return (LANDUSE_MIXED | FLAG_FEATURE_AERA);
-	if(value == "residential")      // base layer
-		return (LANDUSE_RESIDENTIAL | FLAG_FEATURE_AERA);
-	if(value == "construction")     // secondary layer?
-		return (LANDUSE_INDUSTRIAL | FLAG_FEATURE_AERA);
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_landuse_tags, s_landuse_slots, s_landuse_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_natural_tags[] =
+{
+	{"wood",      LANDUSE_WOOD  | FLAG_FEATURE_AERA},
+	{"grassland", LANDUSE_GRASS | FLAG_FEATURE_AERA},
+	{"water",     NATURAL_WATER | FLAG_FEATURE_AERA},
+	{"shingle",   NATURAL_WET | FLAG_FEATURE_AERA},
+	{"tree",      8 | FLAG_FEATURE_NODE | TYPE_POI_N_TREE | TYPE_NATURAL},	// POI
+};
+OSM_TAG_TABLE(s_natural, 16, 0x811C9DC6U)
+
 uint64_t TrImportOsmRel::getNaturalClass(const QString & value)
 {
-	if(value == "wood")
-		//return (NATURAL_FOREST | FLAG_FEATURE_AERA);
-		return (LANDUSE_WOOD  | FLAG_FEATURE_AERA);
-	if(value == "grassland")
-		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
-	if(value == "water")
-		return (NATURAL_WATER | FLAG_FEATURE_AERA);
-	if(value == "shingle")
-		return (NATURAL_WET | FLAG_FEATURE_AERA);
-
-	if(value == "tree")	// POI
-	{
-		//TR_INF << "-----tree------";
-		return (8 | FLAG_FEATURE_NODE | TYPE_POI_N_TREE | TYPE_NATURAL);
-	}
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_natural_tags, s_natural_slots, s_natural_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_waterway_tags[] =
+{
+	{"river",  WATER_RIVER | FLAG_FEATURE_AERA},
+	{"stream", WATER_STREAM | FLAG_FEATURE_AERA},	//FLAG_FEATURE_WAY);
+};
+OSM_TAG_TABLE(s_waterway, 4, 0x811C9DC5U)
+
 uint64_t TrImportOsmRel::getWaterWayClass(const QString & value)
 {
-	if(value == "river")
-		return (WATER_RIVER | FLAG_FEATURE_AERA);
-	if(value == "stream")
-		return (WATER_STREAM | FLAG_FEATURE_AERA); //FLAG_FEATURE_WAY);
-	return 0;
+	uint64_t code = 0;
+	osmTagFind(s_waterway_tags, s_waterway_slots, s_waterway_seed, value, code);
+	return code;
 }
 
+static constexpr OsmTagEntry s_railway_tags[] =
+{
+	{"rail",         0x0000000000000080},
+	{"subway",       0x0000000000000090},
+	{"light_rail",   0x00000000000000A0},
+	{"tram",         0x00000000000000A0},
+	{"narrow_gauge", 0x00000000000000B0},
+};
+OSM_TAG_TABLE(s_railway, 16, 0x811C9DC5U)
+
 uint64_t TrImportOsmRel::getRailWayClass(const QString & value)
 {
-    if(value == "rail")
-        return 0x0000000000000080;
-    if(value == "subway")
-        return 0x0000000000000090;
-    if(value == "light_rail")
-        return 0x00000000000000A0;
-    if(value == "tram")
-        return 0x00000000000000A0;
-    if(value == "narrow_gauge")
-        return 0x00000000000000B0;
-    return 0;
+	uint64_t code = 0;
+	osmTagFind(s_railway_tags, s_railway_slots, s_railway_seed, value, code);
+	return code;
 }
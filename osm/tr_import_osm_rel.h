@@ -50,9 +50,12 @@
 
 #include <QtCore/qxmlstream.h>
 
+#include "tr_osm_xml_scan.h"
+
 // TODO: use own class/module?
 struct Relation
 {
+    uint64_t m_id;
     uint64_t m_flags;
 	QVector<RelMember_t> m_members;
 
@@ -60,7 +63,7 @@ struct Relation
     friend QDebug operator<<(QDebug dbg, const Relation& member);
 
 	int isMultiPolyRing();
-	void resetPolyRing(QMap<uint64_t, Way_t> & waylist);
+	void resetPolyRing(Way_t * ways, size_t n_way);
 };
 
 
@@ -70,15 +73,13 @@ private:
 	QMap<QString, QString> m_tags;
 	int64_t m_id;
 
-	void closeRelation(QMap<uint64_t, Way_t> & waylist, Relation & rel);
-
-	bool handleMultiPoly(QMap<uint64_t, Way_t> & waylist, Relation & rel);
+	bool handleMultiPoly(Way_t * ways, size_t n_way, Relation & rel);
 
 public:
 	TrImportOsmRel();
 	virtual ~TrImportOsmRel();
 
-	bool osmRelationRead(QXmlStreamReader & xml, QMap<uint64_t, Way_t> & waylist, Relation & rel);
+	bool osmRelationRead(QXmlStreamReader & xml, Way_t * ways, size_t n_way, Relation & rel);
 			//QMap<uint64_t, Rel_t> & rellist);
 
 	void readRelation(const QXmlStreamAttributes &attributes, Relation & rel);
@@ -86,6 +87,19 @@ public:
 	void readTag(const QXmlStreamAttributes &attributes);
 	void readMember(const QXmlStreamAttributes &attributes, Relation & rel);
 
+	bool osmRelationRead(TrOsmXmlScan & xml, Way_t * ways, size_t n_way, Relation & rel);
+
+	void readTag(const TrOsmXmlScan & scan);
+	void readMember(const TrOsmXmlScan & scan, Relation & rel);
+
+	// used by the binary formats, without a XML reader
+	void beginRelation(uint64_t id, Relation & rel);
+	void addTag(const QString & key, const QString & value);
+	void addWayMember(uint64_t id, const OsmView_t & role, Relation & rel);
+	void closeRelation(Way_t * ways, size_t n_way, Relation & rel);
+
+	static Way_t * findWay(Way_t * ways, size_t n_way, uint64_t id);
+
 	static uint64_t getBuildingClass(const QString & value);
 	static uint64_t getBarrierClass(const QString & value);
 	static uint64_t getLanduseClass(const QString & value);
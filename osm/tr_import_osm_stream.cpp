@@ -41,29 +41,99 @@
 
 #include <tr_prof_class_def.h>
 
+#include <QtCore/qfuture.h>
+#include <QtCore/qthread.h>
+#include <QtConcurrent/qtconcurrentmap.h>
+
+#include "osm_num.h"
+#include "osm_tag_hash.h"
+
+#include <algorithm>
+#include <string.h>
+
+// first size of the node and way stores, doubled when needed
+#define OSM_STORE_START_SIZE  (64 * 1024)
+
+// size of the XML parts for osmReadParallel
+#define OSM_XML_CHUNK_SIZE  (8 * 1024 * 1024)
+// number of chunks per thread, decoded before they are added
+#define OSM_CHUNKS_PER_THREAD  4
+
 TrImportOsmStream::TrImportOsmStream(const QString & name)
 	: TrGeoObject()
+	, m_tag_count(0)
+	, m_text_count(0)
 	, m_id(0)
-	, m_point{0.0,0.0}
+	, m_coor{0,0}
+	, m_node_ids(nullptr)
+	, m_node_coor(nullptr)
+	, m_node_count(0)
+	, m_node_size(0)
+	, m_pois(nullptr)
+	, m_poi_count(0)
+	, m_poi_size(0)
+	, m_ways(nullptr)
+	, m_way_count(0)
+	, m_way_size(0)
+	, m_refs(nullptr)
+	, m_ref_count(0)
+	, m_ref_size(0)
+	, m_ref_start(0)
+	, m_nodes_sorted(true)
+	, m_ways_sorted(true)
+	, m_pass(AllPass)
+	, m_clip(nullptr)
 {
 	m_filename = name;
 }
 
 TrImportOsmStream::TrImportOsmStream()
 	: TrGeoObject()
+	, m_tag_count(0)
+	, m_text_count(0)
 	, m_id(0)
+	, m_coor{0,0}
+	, m_node_ids(nullptr)
+	, m_node_coor(nullptr)
+	, m_node_count(0)
+	, m_node_size(0)
+	, m_pois(nullptr)
+	, m_poi_count(0)
+	, m_poi_size(0)
+	, m_ways(nullptr)
+	, m_way_count(0)
+	, m_way_size(0)
+	, m_refs(nullptr)
+	, m_ref_count(0)
+	, m_ref_size(0)
+	, m_ref_start(0)
+	, m_nodes_sorted(true)
+	, m_ways_sorted(true)
+	, m_pass(AllPass)
+	, m_clip(nullptr)
 {
 }
 
 TrImportOsmStream::~TrImportOsmStream()
 {
 	//m_poly_points.clear();
+	// not given to World_t
+	free(m_ways);
+	free(m_refs);
+	free(m_node_ids);
+	free(m_node_coor);
+	free(m_pois);
 }
 
 bool TrImportOsmStream::osmRead(World_t & world)
 {
 	QFile file(m_filename);
-	if (!file.open(QFile::ReadOnly | QFile::Text))
+	// .osm.gz and .osm.bz2, decompressed by a reader thread
+	TrOsmInflate inflate(m_filename);
+	QIODevice * device = &file;
+	if(TrOsmInflate::isCompressed(m_filename))
+		device = &inflate;
+	if (!device->open(QFile::ReadOnly | QFile::Text))
 	{
 		// TODO: cleanup
 		return false;
@@ -71,7 +141,7 @@ bool TrImportOsmStream::osmRead(World_t & world)
 
 	QXmlStreamReader xml;
 
-	xml.setDevice(&file);
+	xml.setDevice(device);
 
 	while (!xml.atEnd())
 	{
@@ -80,9 +150,7 @@ bool TrImportOsmStream::osmRead(World_t & world)
 		{
 			if(xml.name() == "osm")
 			{
-				QXmlStreamAttributes attrs = xml.attributes();
-				//readTrackPoint(attrs);
-				world.act_name_idx = 1;
+				beginOsm(world);
 			}
 			if(xml.name() == "node")
 			{
@@ -94,20 +162,23 @@ bool TrImportOsmStream::osmRead(World_t & world)
 				QXmlStreamAttributes attrs = xml.attributes();
 				//TR_INF << m_tags;
 				readWay(attrs);
-				//m_tags.clear();
+				//clearTags();
 			}
 			if(xml.name() == "relation")
 			{
 				TrImportOsmRel rel_read;
 				Relation rel;
-				if(rel_read.osmRelationRead(xml, m_waylist, rel))
+				if(m_pass == NodePass)
 				{
-					// for "multipolygon" -> "face" object
-					//TR_INF << "MULTI_POLY: " << rel.isMultiPolyRing();
-					if(rel.isMultiPolyRing() > 1)
+					// only skipped, the ways are done
+					rel_read.osmRelationRead(xml, nullptr, 0, rel);
+				}
+				else
+				{
+					sortWays();
+					if(rel_read.osmRelationRead(xml, m_ways, m_way_count, rel))
 					{
-						rel.resetPolyRing(m_waylist);
-						addRelation(rel);
+						checkRelation(rel);
 					}
 				}
 			}
@@ -118,11 +189,10 @@ bool TrImportOsmStream::osmRead(World_t & world)
 			}
 			if(xml.name() == "nd")
 			{
-				bool ok;
+				uint64_t ref = 0;
 				QXmlStreamAttributes attrs = xml.attributes();
-				uint64_t ref = attrs.value("ref").toULongLong(&ok);
-				if(ref > 0)
-					m_way_reflist.append(ref);
+				osmParseId(attrs.value("ref"), ref);
+				addNodeRef(ref);
 			}
 		}
 		if(xml.isEndElement())
@@ -133,12 +203,12 @@ bool TrImportOsmStream::osmRead(World_t & world)
 			}
 			if(xml.name() == "node")
 			{
-				closeNode(world.m_name_map, world.act_name_idx, world.m_point_name_map);
+				closeNode(world.m_names);
 			}
 			if(xml.name() == "way")
 			{
 				//TR_INF << "close way" << m_tags;
-				closeWay(world.m_name_map, world.act_name_idx);
+				closeWay(world.m_names);
 			}
 			if(xml.name() == "relation")
 			{
@@ -162,9 +232,612 @@ bool TrImportOsmStream::osmRead(World_t & world)
 	return true;
 }
 
-QMap<uint64_t, Point_t> & TrImportOsmStream::getNodeMap()
+// next "<node", "<way" or "<relation" behind 'pos'; '<' is not allowed
+// inside of attribute values, so every '<' is the start of a tag
+static size_t nextElement(const char * data, size_t pos, size_t size)
+{
+	while(pos < size)
+	{
+		const char * lt = static_cast<const char *>(memchr(data + pos, '<', size - pos));
+		if(lt == nullptr)
+			return size;
+		pos = lt - data;
+		OsmView_t name = osmView(lt + 1, static_cast<int32_t>(qMin<size_t>(size - pos - 1, 9)));
+		if(osmViewStartsWith(name, "node") || osmViewStartsWith(name, "way") ||
+				osmViewStartsWith(name, "relation"))
+		{
+			// "<node " but not "<nodes"
+			int32_t len = (name.ptr[0] == 'n') ? 4 : ((name.ptr[0] == 'w') ? 3 : 8);
+			if((name.len > len) && ((name.ptr[len] == ' ') || (name.ptr[len] == '>') ||
+					(name.ptr[len] == '/') || (name.ptr[len] == '\t') ||
+					(name.ptr[len] == '\n') || (name.ptr[len] == '\r')))
+				return pos;
+		}
+		pos++;
+	}
+	return size;
+}
+
+// same as osmRead, but the file is mapped and the attributes are used
+// without a copy (QXmlStreamAttributes/QString) for each element
+bool TrImportOsmStream::osmReadMapped(World_t & world)
+{
+	if(TrOsmInflate::isCompressed(m_filename))
+		return osmReadInflate(world);
+
+	QFile file(m_filename);
+	if (!file.open(QFile::ReadOnly))
+	{
+		return false;
+	}
+
+	uchar * data = file.map(0, file.size());
+	if(data == nullptr)
+	{
+		TR_WRN << "mapping failed, use stream mode" << m_filename;
+		file.close();
+		return osmRead(world);
+	}
+
+	TrOsmXmlScan xml;
+
+	xml.setData(reinterpret_cast<const char *>(data), static_cast<size_t>(file.size()));
+	scanXml(xml, world);
+	bool failed = (xml.hasError() || (xml.readNext() == TrOsmXmlScan::NeedData));
+	file.unmap(data);
+	if (failed)
+	{
+		TR_ERR << "file incomplete or invalid:" << xml.errorString();
+		return false;
+	}
+	this->setSurroundingRect();
+	return true;
+}
+
+// the elements of the buffer, used for the mapped file and for each window of osmReadInflate
+void TrImportOsmStream::scanXml(TrOsmXmlScan & xml, World_t & world)
+{
+	while (!xml.atEnd())
+	{
+		xml.readNext();
+		if(xml.isStartElement())
+		{
+			const OsmView_t & name = xml.name();
+			if(osmViewIs(name, "osm"))
+			{
+				beginOsm(world);
+			}
+			else if(osmViewIs(name, "node"))
+			{
+				readNodePoint(xml);
+			}
+			else if(osmViewIs(name, "way"))
+			{
+				readWay(xml);
+			}
+			else if(osmViewIs(name, "relation"))
+			{
+				TrImportOsmRel rel_read;
+				Relation rel;
+				if(m_pass == NodePass)
+				{
+					// only skipped, the ways are done
+					rel_read.osmRelationRead(xml, nullptr, 0, rel);
+				}
+				else
+				{
+					sortWays();
+					if(rel_read.osmRelationRead(xml, m_ways, m_way_count, rel))
+					{
+						checkRelation(rel);
+					}
+				}
+			}
+			else if(osmViewIs(name, "tag"))
+			{
+				readTag(xml);
+			}
+			else if(osmViewIs(name, "nd"))
+			{
+				OsmView_t value;
+				uint64_t ref = 0;
+				xml.attribute("ref", value);
+				osmParseId(value.ptr, value.len, ref);
+				addNodeRef(ref);
+			}
+		}
+		if(xml.isEndElement())
+		{
+			const OsmView_t & name = xml.name();
+			if(osmViewIs(name, "osm"))
+			{
+				closeOsm(world);
+			}
+			else if(osmViewIs(name, "node"))
+			{
+				closeNode(world.m_names);
+			}
+			else if(osmViewIs(name, "way"))
+			{
+				closeWay(world.m_names);
+			}
+		}
+	}
+}
+
+// start of the last "<node", "<way" or "<relation", 0 if there is none behind the start
+static size_t lastElement(const char * data, size_t size)
+{
+	size_t from = size / 2;
+	while(true)
+	{
+		size_t last = 0;
+		size_t pos = nextElement(data, from, size);
+		while(pos < size)
+		{
+			last = pos;
+			pos = nextElement(data, pos + 1, size);
+		}
+		if((last > 0) || (from <= 1))
+			return last;
+		from = 1;
+	}
+}
+
+// The decompressed data is scanned in windows, each window ends in front
+// of the last element start, the rest is moved to the next window.
+bool TrImportOsmStream::osmReadInflate(World_t & world)
+{
+	TrOsmInflate inflate(m_filename);
+	if(!inflate.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	size_t size = OSM_XML_CHUNK_SIZE;
+	char * data = static_cast<char *>(malloc(size));
+	if(data == nullptr)
+	{
+		TR_ERR << "no memory for the XML window";
+		return false;
+	}
+	size_t fill = 0;
+	bool end = false;
+	bool failed = false;
+	TrOsmXmlScan xml;
+	while((!end) && (!failed))
+	{
+		qint64 n = inflate.read(data + fill, static_cast<qint64>(size - fill));
+		if(n < 0)
+		{
+			failed = true;
+			break;
+		}
+		fill += static_cast<size_t>(n);
+		end = inflate.atEnd();
+
+		size_t cut = end ? fill : lastElement(data, fill);
+		if(cut == 0)
+		{
+			// one element is larger than the window
+			if(fill == size)
+			{
+				char * larger = static_cast<char *>(realloc(data, size * 2));
+				if(larger == nullptr)
+				{
+					TR_ERR << "no memory for the XML window";
+					failed = true;
+					break;
+				}
+				data = larger;
+				size *= 2;
+			}
+			continue;
+		}
+		xml.setData(data, cut);
+		scanXml(xml, world);
+		failed = (xml.hasError() || (xml.readNext() == TrOsmXmlScan::NeedData));
+		memmove(data, data + cut, fill - cut);
+		fill -= cut;
+	}
+	free(data);
+	if (failed)
+	{
+		TR_ERR << "file incomplete or invalid:" << xml.errorString() << inflate.inflateError();
+		return false;
+	}
+	this->setSurroundingRect();
+	return true;
+}
+
+void TrImportOsmStream::beginOsm(World_t & world)
+{
+	// the second pass continues with the names
+	if(m_pass != NodePass)
+		world.m_names.clear();
+}
+
+void TrImportOsmStream::setPass(Pass pass)
+{
+	m_pass = pass;
+}
+
+void TrImportOsmStream::setClip(const TrOsmClip * clip)
+{
+	m_clip = clip;
+}
+
+void TrImportOsmStream::beginNode(uint64_t id, int32_t x, int32_t y)
+{
+	m_id = id;
+	m_coor.x = x;
+	m_coor.y = y;
+	clearTags();
+}
+
+void TrImportOsmStream::beginWay(uint64_t id)
+{
+	m_id = id;
+	m_ref_start = m_ref_count;
+	clearTags();
+}
+
+void TrImportOsmStream::addTag(const QString & key, const QString & value)
+{
+	uint32_t id = tagKey(key.utf16(), key.size());
+	if(id == OSM_TAG_NONE)
+		return;
+	if(findTag(id) >= 0)
+	{
+		TR_WRN << "double use: " << key << value;
+		return;
+	}
+	uint32_t v_id = OSM_TAG_NONE;
+	if(!TrOsmTagPool::isTextKey(id))
+		v_id = m_pool.intern(value.utf16(), value.size());
+	if(v_id == OSM_TAG_NONE)
+		v_id = appendText(value);
+	appendTag(id, v_id);
+}
+
+void TrImportOsmStream::addTag(uint32_t key, const OsmView_t & value, bool xml)
+{
+	if(findTag(key) >= 0)
+	{
+		TR_WRN << "double use: " << m_pool.string(key) << QByteArray(value.ptr, value.len);
+		return;
+	}
+	uint32_t v_id = OSM_TAG_NONE;
+	// entities are decoded by toString
+	if(xml && (memchr(value.ptr, '&', value.len) != nullptr))
+	{
+		QString text = TrOsmXmlScan::toString(value);
+		if(!TrOsmTagPool::isTextKey(key))
+			v_id = m_pool.intern(text.utf16(), text.size());
+		if(v_id == OSM_TAG_NONE)
+			v_id = appendText(text);
+		appendTag(key, v_id);
+		return;
+	}
+	if(!TrOsmTagPool::isTextKey(key))
+		v_id = m_pool.intern(value.ptr, value.len);
+	// UTF-8
+	if(v_id == OSM_TAG_NONE)
+		v_id = appendText(QString::fromUtf8(value.ptr, value.len));
+	appendTag(key, v_id);
+}
+
+void TrImportOsmStream::addNodeRef(uint64_t ref)
+{
+	if(ref > 0)
+		appendRef(ref);
+}
+
+void TrImportOsmStream::endNode(World_t & world)
+{
+	closeNode(world.m_names);
+}
+
+void TrImportOsmStream::endWay(World_t & world)
+{
+	closeWay(world.m_names);
+}
+
+// the tags and members of 'rel' are set by the caller
+void TrImportOsmStream::endRelation(TrImportOsmRel & rel_read, Relation & rel)
+{
+	if(m_pass == NodePass)
+		return;
+	sortWays();
+	rel_read.closeRelation(m_ways, m_way_count, rel);
+	checkRelation(rel);
+}
+
+void TrImportOsmStream::endOsm(World_t & world)
+{
+	closeOsm(world);
+}
+
+// the key id is set by the worker, only the keys of the pool are looked up here
+void TrImportOsmStream::addBlockTag(const OsmBlock & block, uint32_t key, uint32_t value)
+{
+	uint32_t id = block.keys[key];
+	if(id == OSM_KEY_COUNT)
+	{
+		const OsmView_t & view = block.views[key];
+		id = tagKey(view.ptr, view.len);
+	}
+	if(id == OSM_TAG_NONE)
+		return;
+	addTag(id, block.views[value], block.xml);
+}
+
+static QString blockString(const OsmBlock & block, uint32_t index)
+{
+	const OsmView_t & view = block.views[index];
+	if(block.xml)
+		return TrOsmXmlScan::toString(view);
+	return QString::fromUtf8(view.ptr, view.len);
+}
+
+void TrImportOsmStream::addBlock(const OsmBlock & block, World_t & world)
+{
+	const uint32_t * tags = block.tags.constData();
+
+	for(int i = 0; i < block.nodes.size(); i++)
+	{
+		const OsmBlockNode_t & node = block.nodes[i];
+		beginNode(node.id, node.x, node.y);
+		for(uint32_t t = node.tag; t < node.tag + node.n_tag; t++)
+			addBlockTag(block, tags[2*t], tags[2*t+1]);
+		endNode(world);
+	}
+	for(int i = 0; i < block.ways.size(); i++)
+	{
+		const OsmBlockWay_t & way = block.ways[i];
+		beginWay(way.id);
+		for(uint32_t t = way.tag; t < way.tag + way.n_tag; t++)
+			addBlockTag(block, tags[2*t], tags[2*t+1]);
+		for(uint32_t r = way.ref; r < way.ref + way.n_ref; r++)
+			addNodeRef(block.refs[r]);
+		endWay(world);
+	}
+	for(int i = 0; i < block.rels.size(); i++)
+	{
+		const OsmBlockRel_t & prel = block.rels[i];
+		TrImportOsmRel rel_read;
+		Relation rel;
+
+		rel_read.beginRelation(prel.id, rel);
+		for(uint32_t t = prel.tag; t < prel.tag + prel.n_tag; t++)
+			rel_read.addTag(blockString(block, tags[2*t]), blockString(block, tags[2*t+1]));
+		for(uint32_t m = prel.mem; m < prel.mem + prel.n_mem; m++)
+		{
+			const OsmBlockMember_t & member = block.members[m];
+			if(member.type == 1)
+				rel_read.addWayMember(member.id, block.views[member.role], rel);
+		}
+		endRelation(rel_read, rel);
+	}
+}
+
+bool TrImportOsmStream::addBlocks(const QVector<OsmChunk_t> & chunks,
+		OsmBlock (*decode)(const OsmChunk_t &), World_t & world, QString & error)
+{
+	// decoding of the next chunks is running while the last ones are added
+	int batch = QThread::idealThreadCount() * OSM_CHUNKS_PER_THREAD;
+	if(batch < OSM_CHUNKS_PER_THREAD)
+		batch = OSM_CHUNKS_PER_THREAD;
+
+	int pos = 0;
+	QFuture<OsmBlock> act = QtConcurrent::mapped(chunks.mid(pos, batch), decode);
+	while(true)
+	{
+		QList<OsmBlock> result = act.results();
+		pos += batch;
+
+		QFuture<OsmBlock> next;
+		bool has_next = (pos < chunks.size());
+		if(has_next)
+			next = QtConcurrent::mapped(chunks.mid(pos, batch), decode);
+
+		for(int i = 0; i < result.size(); i++)
+		{
+			if(!result[i].ok)
+			{
+				error = result[i].error;
+				// the workers are using the mapped file
+				next.cancel();
+				next.waitForFinished();
+				return false;
+			}
+			addBlock(result[i], world);
+		}
+		if(!has_next)
+			break;
+		act = next;
+	}
+	return true;
+}
+
+// static, a key of the pool needs the sink
+uint32_t TrImportOsmStream::blockKey(const OsmView_t & key)
+{
+	uint32_t id = TrOsmTagPool::fixedKey(key.ptr, key.len);
+	if(id != OSM_TAG_NONE)
+		return id;
+	// see tagKey()
+	if(osmViewStartsWith(key, "parking"))
+		return OSM_KEY_COUNT;
+	return OSM_TAG_NONE;
+}
+
+// the text is not copied, the sink converts only the used values
+static uint32_t chunkView(OsmBlock & block, const OsmView_t & view, uint32_t key)
+{
+	block.views.append(view);
+	block.keys.append(key);
+	return block.views.size() - 1;
+}
+
+// static, called by the worker threads
+OsmBlock TrImportOsmStream::decodeChunk(const OsmChunk_t & chunk)
+{
+	OsmBlock block;
+	TrOsmXmlScan xml;
+	OsmView_t value;
+	OsmView_t key;
+	// element for <tag>, <nd> and <member>: 'n', 'w', 'r'
+	char act = 0;
+
+	block.xml = true;
+	xml.setData(chunk.data, chunk.size);
+	while (!xml.atEnd())
+	{
+		xml.readNext();
+		if(!xml.isStartElement())
+			continue;
+
+		const OsmView_t & name = xml.name();
+		if(osmViewIs(name, "node"))
+		{
+			OsmBlockNode_t node;
+			xml.attribute("id", value);
+			if(!osmParseId(value.ptr, value.len, node.id))
+				TR_WRN << "integer fault" << QByteArray(value.ptr, value.len);
+			xml.attribute("lon", value);
+			if(!osmParseCoor(value.ptr, value.len, node.x))
+				TR_WRN << "float fault" << QByteArray(value.ptr, value.len);
+			xml.attribute("lat", value);
+			if(!osmParseCoor(value.ptr, value.len, node.y))
+				TR_WRN << "float fault" << QByteArray(value.ptr, value.len);
+			node.tag = block.tags.size() / 2;
+			node.n_tag = 0;
+			block.nodes.append(node);
+			act = 'n';
+		}
+		else if(osmViewIs(name, "way"))
+		{
+			OsmBlockWay_t way;
+			xml.attribute("id", value);
+			if(!osmParseId(value.ptr, value.len, way.id))
+				TR_WRN << "integer fault" << QByteArray(value.ptr, value.len);
+			way.tag = block.tags.size() / 2;
+			way.n_tag = 0;
+			way.ref = block.refs.size();
+			way.n_ref = 0;
+			block.ways.append(way);
+			act = 'w';
+		}
+		else if(osmViewIs(name, "relation"))
+		{
+			OsmBlockRel_t rel;
+			xml.attribute("id", value);
+			osmParseId(value.ptr, value.len, rel.id);
+			rel.tag = block.tags.size() / 2;
+			rel.n_tag = 0;
+			rel.mem = block.members.size();
+			rel.n_mem = 0;
+			block.rels.append(rel);
+			act = 'r';
+		}
+		else if(osmViewIs(name, "tag"))
+		{
+			if(!xml.attribute("k", key) || !xml.attribute("v", value))
+				continue;
+			// a relation keeps all tags, see TrImportOsmRel::closeRelation
+			uint32_t key_id = blockKey(key);
+			if((key_id == OSM_TAG_NONE) && (act != 'r'))
+				continue;
+			block.tags.append(chunkView(block, key, key_id));
+			block.tags.append(chunkView(block, value, OSM_TAG_NONE));
+			if(act == 'n')
+				block.nodes.last().n_tag++;
+			else if(act == 'w')
+				block.ways.last().n_tag++;
+			else if(act == 'r')
+				block.rels.last().n_tag++;
+		}
+		else if(osmViewIs(name, "nd") && (act == 'w'))
+		{
+			uint64_t ref = 0;
+			xml.attribute("ref", value);
+			if(!osmParseId(value.ptr, value.len, ref))
+				TR_WRN << "integer fault" << QByteArray(value.ptr, value.len);
+			if(ref > 0)
+			{
+				block.refs.append(ref);
+				block.ways.last().n_ref++;
+			}
+		}
+		else if(osmViewIs(name, "member") && (act == 'r'))
+		{
+			OsmBlockMember_t member;
+			if(!xml.attribute("type", value) || !osmViewIs(value, "way"))
+				continue;
+			xml.attribute("ref", value);
+			if(!osmParseId(value.ptr, value.len, member.id))
+				continue;
+			member.type = 1;
+			xml.attribute("role", value);
+			member.role = chunkView(block, value, OSM_TAG_NONE);
+			block.members.append(member);
+			block.rels.last().n_mem++;
+		}
+	}
+	if (xml.hasError())
+	{
+		block.error = xml.errorString();
+		return block;
+	}
+	block.ok = true;
+	return block;
+}
+
+bool TrImportOsmStream::osmReadParallel(World_t & world)
 {
-	return m_nodelist;
+	QFile file(m_filename);
+	if (!file.open(QFile::ReadOnly))
+	{
+		return false;
+	}
+
+	uchar * map = file.map(0, file.size());
+	if(map == nullptr)
+	{
+		TR_WRN << "mapping failed, use stream mode" << m_filename;
+		file.close();
+		return osmRead(world);
+	}
+
+	const char * data = reinterpret_cast<const char *>(map);
+	size_t size = static_cast<size_t>(file.size());
+	QVector<OsmChunk_t> chunks;
+	size_t pos = 0;
+	while(pos < size)
+	{
+		OsmChunk_t chunk;
+		size_t end = size;
+		if(size - pos > OSM_XML_CHUNK_SIZE)
+			end = nextElement(data, pos + OSM_XML_CHUNK_SIZE, size);
+		chunk.data = data + pos;
+		chunk.size = static_cast<uint32_t>(end - pos);
+		chunk.raw_size = 0;
+		chunks.append(chunk);
+		pos = end;
+	}
+	TR_INF << "chunks:" << chunks.size();
+
+	QString error;
+	beginOsm(world);
+	if(!addBlocks(chunks, &TrImportOsmStream::decodeChunk, world, error))
+	{
+		TR_ERR << error;
+		return false;
+	}
+	endOsm(world);
+	file.unmap(map);
+	return true;
 }
 
 QVector<Rel_t> & TrImportOsmStream::getRelationList()
@@ -185,89 +858,214 @@ bool TrImportOsmStream::setSurroundingRect()
 
 void TrImportOsmStream::readTag(const QXmlStreamAttributes &attributes)
 {
-	QString key = attributes.value("k").toString();
-	QString value = attributes.value("v").toString();
-	if(m_tags.contains(key))
+	QStringRef key = attributes.value("k");
+	QStringRef value = attributes.value("v");
+
+	uint32_t id = tagKey(reinterpret_cast<const ushort *>(key.unicode()), key.size());
+	if(id == OSM_TAG_NONE)
+		return;
+	if(findTag(id) >= 0)
 	{
 		TR_WRN << "double use: " << key << value;
+		return;
 	}
-	else
-	{
-		m_tags[key] = value;
-	}
+	uint32_t v_id = OSM_TAG_NONE;
+	if(!TrOsmTagPool::isTextKey(id))
+		v_id = m_pool.intern(reinterpret_cast<const ushort *>(value.unicode()), value.size());
+	// the reference is valid up to the next token only
+	if(v_id == OSM_TAG_NONE)
+		v_id = appendText(value.toString());
+	appendTag(id, v_id);
 }
 
 void TrImportOsmStream::readNodePoint(const QXmlStreamAttributes &attributes)
 {
-	bool ok;
-
 	//<node id="134" version="1" lon="11.50333" lat="48.12541"/>
-	m_id = attributes.value("id").toULongLong(&ok);
-	if(!ok)
+	if(!osmParseId(attributes.value("id"), m_id))
 		TR_WRN << "integer fault" << attributes.value("id");
-	m_point.x = attributes.value("lon").toDouble(&ok) * TR_COOR_FACTOR;
-	if(!ok)
+	if(!osmParseCoor(attributes.value("lon"), m_coor.x))
 		TR_WRN << "float fault" << attributes.value("lon");
-	m_point.y = attributes.value("lat").toDouble(&ok) * TR_COOR_FACTOR;
-	if(!ok)
+	if(!osmParseCoor(attributes.value("lat"), m_coor.y))
 		TR_WRN << "float fault" << attributes.value("lat");
 }
 
-void TrImportOsmStream::closeNode(QMap<QString, name_set> & name_map,
-		uint64_t & act_id, QMap<uint64_t, QString> & n_map)
+void TrImportOsmStream::readTag(const TrOsmXmlScan & scan)
+{
+	OsmView_t key;
+	OsmView_t value;
+	if(!scan.attribute("k", key) || !scan.attribute("v", value))
+		return;
+
+	// entities are decoded by toString
+	if((memchr(key.ptr, '&', key.len) != nullptr) || (memchr(value.ptr, '&', value.len) != nullptr))
+	{
+		addTag(TrOsmXmlScan::toString(key), TrOsmXmlScan::toString(value));
+		return;
+	}
+	uint32_t id = tagKey(key.ptr, key.len);
+	if(id == OSM_TAG_NONE)
+		return;
+	addTag(id, value, true);
+}
+
+// pool id of a key used by closeNode() or closeWay(), OSM_TAG_NONE for all other keys
+template <typename C>
+uint32_t TrImportOsmStream::tagKey(const C * key, int len)
+{
+	static const char s_parking[] = "parking";
+
+	uint32_t id = m_pool.find(key, len);
+	if(id < OSM_KEY_COUNT)
+		return id;
+	// exp: 'parking:left:orientation', see getParking()
+	if(len < 7)
+		return OSM_TAG_NONE;
+	for(int i = 0; i < 7; i++)
+	{
+		if(static_cast<ushort>(key[i]) != static_cast<ushort>(s_parking[i]))
+			return OSM_TAG_NONE;
+	}
+	return m_pool.intern(key, len);
+}
+
+int TrImportOsmStream::findTag(uint32_t key) const
+{
+	for(int i = 0; i < m_tag_count; i++)
+	{
+		if(m_tag_list[i].key == key)
+			return i;
+	}
+	return -1;
+}
+
+bool TrImportOsmStream::hasTag(uint32_t key) const
+{
+	return (findTag(key) >= 0);
+}
+
+const QString & TrImportOsmStream::tagValue(uint32_t key) const
+{
+	static const QString s_empty;
+
+	int i = findTag(key);
+	if(i < 0)
+		return s_empty;
+	return tagString(m_tag_list[i].value);
+}
+
+const QString & TrImportOsmStream::tagString(uint32_t value) const
+{
+	if(value & OSM_TAG_TEXT)
+		return m_tag_text[static_cast<int>(value & ~OSM_TAG_TEXT)];
+	return m_pool.string(value);
+}
+
+void TrImportOsmStream::appendTag(uint32_t key, uint32_t value)
+{
+	if(m_tag_count >= m_tag_list.size())
+		m_tag_list.resize(m_tag_count + 16);
+	m_tag_list[m_tag_count].key = key;
+	m_tag_list[m_tag_count].value = value;
+	m_tag_count++;
+}
+
+uint32_t TrImportOsmStream::appendText(const QString & text)
 {
-	Point_t point;
+	if(m_text_count >= m_tag_text.size())
+		m_tag_text.resize(m_text_count + 8);
+	m_tag_text[m_text_count] = text;
+	return static_cast<uint32_t>(m_text_count++) | OSM_TAG_TEXT;
+}
+
+// the arrays are kept for the next element
+void TrImportOsmStream::clearTags()
+{
+	m_tag_count = 0;
+	m_text_count = 0;
+}
+
+void TrImportOsmStream::readNodePoint(const TrOsmXmlScan & scan)
+{
+	OsmView_t value;
+
+	scan.attribute("id", value);
+	if(!osmParseId(value.ptr, value.len, m_id))
+		TR_WRN << "integer fault" << QByteArray(value.ptr, value.len);
+	scan.attribute("lon", value);
+	if(!osmParseCoor(value.ptr, value.len, m_coor.x))
+		TR_WRN << "float fault" << QByteArray(value.ptr, value.len);
+	scan.attribute("lat", value);
+	if(!osmParseCoor(value.ptr, value.len, m_coor.y))
+		TR_WRN << "float fault" << QByteArray(value.ptr, value.len);
+}
+
+void TrImportOsmStream::closeNode(TrOsmNameDict & names)
+{
+	Poi_t poi;
+
+	if((m_pass == WayPass) && (m_clip != nullptr) && (m_id > 0) &&
+			m_clip->contains(m_coor.x, m_coor.y))
+		m_node_inside.set(m_id);
+	// not used by a way and outside: neither a way point nor a POI
+	if((m_pass == WayPass) || ((m_pass == NodePass) && (m_clip != nullptr) &&
+			(!m_node_used.contains(m_id)) && (!m_clip->contains(m_coor.x, m_coor.y))))
+	{
+		m_id = 0;
+		clearTags();
+		return;
+	}
 
-    point.x = static_cast<int32_t>(m_point.x * 100.0);
-    point.y = static_cast<int32_t>(m_point.y * 100.0);
-	point.id = m_id;
+	poi.x = m_coor.x;
+	poi.y = m_coor.y;
+	poi.id = m_id;
+	poi.name_id = 0;
 
-	point.pt_type = 0;
-	if(m_tags.contains("highway"))
+	poi.pt_type = 0;
+	if(hasTag(OSM_KEY_HIGHWAY))
 	{
-		uint64_t code = TrImportOsmRel::getHighwayPointClass(m_tags["highway"]);
+		uint64_t code = TrImportOsmRel::getHighwayPointClass(tagValue(OSM_KEY_HIGHWAY));
 		if(code)
 		{
-			point.pt_type = code;
+			poi.pt_type = code;
 		}
 	}
-	if(m_tags.contains("railway"))
+	if(hasTag(OSM_KEY_RAILWAY))
 	{
-		uint64_t code = TrImportOsmRel::getRailwayPointClass(m_tags["railway"]);
+		uint64_t code = TrImportOsmRel::getRailwayPointClass(tagValue(OSM_KEY_RAILWAY));
 		if(code)
 		{
-			point.pt_type = code;
+			poi.pt_type = code;
 		}
 	}
-	if(m_tags.contains("natural"))
+	if(hasTag(OSM_KEY_NATURAL))
 	{
-		uint64_t code = TrImportOsmRel::getNaturalClass(m_tags["natural"]);
+		uint64_t code = TrImportOsmRel::getNaturalClass(tagValue(OSM_KEY_NATURAL));
 		if(code)
 		{
-			point.pt_type = code;
+			poi.pt_type = code;
 		}
 	}
-	if(m_tags.contains("amenity"))
+	if(hasTag(OSM_KEY_AMENITY))
 	{
-		uint64_t code = TrImportOsmRel::getAmenityClass(m_tags["amenity"]);
+		uint64_t code = TrImportOsmRel::getAmenityClass(tagValue(OSM_KEY_AMENITY));
 		if(code)
 		{
-			point.pt_type = code;
+			poi.pt_type = code;
 			//act_world->node_flags & (TYPE_FILTER | 0xffffffff00000000);
-			//TR_INF << ">> amenity" << HEX << code << point.pt_type;
+			//TR_INF << ">> amenity" << HEX << code << poi.pt_type;
 		}
 	}
-	if(m_tags.contains("shop"))
+	if(hasTag(OSM_KEY_SHOP))
 	{
-		uint64_t code = TrImportOsmRel::getShopClass(m_tags["shop"]);
+		uint64_t code = TrImportOsmRel::getShopClass(tagValue(OSM_KEY_SHOP));
 		if(code)
 		{
-			point.pt_type = code;
+			poi.pt_type = code;
 		}
 	}
-	if(m_tags.contains("barrier"))
+	if(hasTag(OSM_KEY_BARRIER))
 	{
-		uint64_t code = TrImportOsmRel::getBarrierClass(m_tags["barrier"]);
+		uint64_t code = TrImportOsmRel::getBarrierClass(tagValue(OSM_KEY_BARRIER));
 		if(code)
 		{
 			// TODO: dummy!
@@ -277,66 +1075,71 @@ void TrImportOsmStream::closeNode(QMap<QString, name_set> & name_map,
 	//<tag k='tourism' v='artwork' />
 	//<tag k='healthcare' v='pharmacy' />
 	//<tag k='leisure' v='fitness_centre' />
-	if(m_tags.contains("name"))
-	{
-		if(!name_map.contains(m_tags["name"]))
-		{
-			name_set set;
-			set.id = act_id;
-			set.number = 1;
-			name_map[m_tags["name"]] = set;
-			// TODO: use of point.id -> crash!
-			point.id = act_id;
-            //TR_INF << "POI: " << point.id << m_tags["name"];
-			n_map[point.id] = m_tags["name"];
-			act_id++;
-		}
-		else
-		{
-			name_map[m_tags["name"]].number++;
-			point.id = name_map[m_tags["name"]].id;
-		}
-	}
+	// temporary id, see closeOsm()
+	if(hasTag(OSM_KEY_NAME))
+		poi.name_id = names.add(tagValue(OSM_KEY_NAME));
 
-	point.pt_data = 0;
+	poi.pt_data = 0;
 
 	if(m_id > 0)
 	{
-		if(m_nodelist.contains(m_id))
-		{
-			TR_WRN << "double use:" << m_id;
-		}
-		else
-		{
-			m_nodelist[m_id] = point;
-		}
+		if(poi.pt_type)
+			appendPoi(poi);
+		// second pass: only the nodes of the used ways
+		if((m_pass != NodePass) || m_node_used.contains(m_id))
+			appendNode(m_id, m_coor.x, m_coor.y);
 	}
 
 	m_id = 0;
-	m_point.x = 0;
-	m_point.y = 0;
+	m_coor.x = 0;
+	m_coor.y = 0;
 
-	m_tags.clear();
+	clearTags();
 }
 
 void TrImportOsmStream::readWay(const QXmlStreamAttributes &attributes)
 {
-	bool ok;
-	m_way_reflist.clear();
-	m_id = attributes.value("id").toULongLong(&ok);
-	if(!ok)
+	m_ref_start = m_ref_count;
+	if(!osmParseId(attributes.value("id"), m_id))
 		TR_WRN << "integer fault" << attributes.value("id");
 
 	//TR_INF << m_id << ok;
 }
 
-void TrImportOsmStream::closeWay(QMap<QString, name_set> & name_map, uint64_t & act_id)
+void TrImportOsmStream::readWay(const TrOsmXmlScan & scan)
+{
+	OsmView_t value;
+
+	m_ref_start = m_ref_count;
+	scan.attribute("id", value);
+	if(!osmParseId(value.ptr, value.len, m_id))
+		TR_WRN << "integer fault" << QByteArray(value.ptr, value.len);
+}
+
+void TrImportOsmStream::closeWay(TrOsmNameDict & names)
 {
 	Way_t way;
+	bool inside = true;
+
+	// the ways outside are kept up to the relations, a multipolygon
+	// inside needs all members for the rings, see markNodes()
+	if((m_pass == WayPass) && (m_clip != nullptr))
+	{
+		inside = wayInside();
+		if(inside && (m_id > 0))
+			m_way_inside.set(m_id);
+	}
+	if(m_pass == NodePass)
+	{
+		m_ref_count = m_ref_start;
+		m_id = 0;
+		clearTags();
+		return;
+	}
 	way.id = m_id;
 	way.name_id = 0;
-	way.nd_id = nullptr;
-	way.n_nd_id = 0;
+	way.nd_ofs = m_ref_start;
+	way.n_nd_id = static_cast<int>(m_ref_count - m_ref_start);
 	way.type = 0;
 	// uint16_t type;
 	// 1 road, 2 rail, ...
@@ -351,9 +1154,9 @@ void TrImportOsmStream::closeWay(QMap<QString, name_set> & name_map, uint64_t &
 	//way.type = TYPE_ROAD | 1;
 	//rd_class = osm2_world.ways[i].type & 0x000000000000000f;
 
-	if(m_tags.contains("highway"))
+	if(hasTag(OSM_KEY_HIGHWAY))
 	{
-		uint64_t code = getClass(m_tags["highway"]);
+		uint64_t code = getClass(tagValue(OSM_KEY_HIGHWAY));
 		if(code)
 		{
 			way.type = TYPE_ROAD | code;
@@ -361,19 +1164,19 @@ void TrImportOsmStream::closeWay(QMap<QString, name_set> & name_map, uint64_t &
 		//TR_INF << HEX << code;
 	}
 
-    if(m_tags.contains("railway"))
+    if(hasTag(OSM_KEY_RAILWAY))
     {
-        uint64_t code = TrImportOsmRel::getRailWayClass(m_tags["railway"]);
-        //TR_INF << "## railway ##" << m_tags["railway"] << HEX << code;
+        uint64_t code = TrImportOsmRel::getRailWayClass(tagValue(OSM_KEY_RAILWAY));
+        //TR_INF << "## railway ##" << tagValue(OSM_KEY_RAILWAY) << HEX << code;
         if(code)
         {
             way.type = TYPE_RAIL | code;
         }
     }
 
-	if(m_tags.contains("barrier"))
+	if(hasTag(OSM_KEY_BARRIER))
 	{
-		uint64_t code = TrImportOsmRel::getBarrierClass(m_tags["barrier"]);
+		uint64_t code = TrImportOsmRel::getBarrierClass(tagValue(OSM_KEY_BARRIER));
 		if(code)
 		{
 			// TODO: dummy!
@@ -381,93 +1184,77 @@ void TrImportOsmStream::closeWay(QMap<QString, name_set> & name_map, uint64_t &
 		}
 	}
 
-	if(m_tags.contains("building"))
+	if(hasTag(OSM_KEY_BUILDING))
 	{
 		// TODO: use: 'building:part'?
-		uint64_t code = TrImportOsmRel::getBuildingClass(m_tags["building"]);
+		uint64_t code = TrImportOsmRel::getBuildingClass(tagValue(OSM_KEY_BUILDING));
 		if(code)
 		{
 			way.type = TYPE_BUILDING | code;
 		}
 	}
 
-	if(m_tags.contains("landuse"))
+	if(hasTag(OSM_KEY_LANDUSE))
 	{
-		uint64_t code = TrImportOsmRel::getLanduseClass(m_tags["landuse"]);
+		uint64_t code = TrImportOsmRel::getLanduseClass(tagValue(OSM_KEY_LANDUSE));
 		if(code)
 		{
 			way.type = TYPE_LANDUSE | code;
 		}
 	}
 
-	if(m_tags.contains("natural"))
+	if(hasTag(OSM_KEY_NATURAL))
 	{
-		uint64_t code = TrImportOsmRel::getNaturalClass(m_tags["natural"]);
+		uint64_t code = TrImportOsmRel::getNaturalClass(tagValue(OSM_KEY_NATURAL));
 		if(code)
 		{
 			way.type = TYPE_NATURAL | code;
 		}
 	}
 
-	if(m_tags.contains("waterway"))
+	if(hasTag(OSM_KEY_WATERWAY))
 	{
-		//TR_INF << m_tags["waterway"];
+		//TR_INF << tagValue(OSM_KEY_WATERWAY);
 	}
 
-	if(m_tags.contains("oneway"))
+	if(hasTag(OSM_KEY_ONEWAY))
 	{
-		uint64_t one = getDir(m_tags["oneway"]) << 32;
+		uint64_t one = getDir(tagValue(OSM_KEY_ONEWAY)) << 32;
         if(!((way.type >> 32) & 0x03))
             way.type |= one;
 		//world_->way_flags |= one;
 	}
 
-    if(m_tags.contains("junction"))
+    if(hasTag(OSM_KEY_JUNCTION))
     {
-        uint64_t one = getDir(m_tags["junction"]) << 32;
+        uint64_t one = getDir(tagValue(OSM_KEY_JUNCTION)) << 32;
         if(!((way.type >> 32) & 0x03))
             way.type |= one;
     }
 
-	if(m_tags.contains("width"))
+	if(hasTag(OSM_KEY_WIDTH))
 	{
 		way.width = 0;
 		bool ok = false;
-		double width = m_tags["width"].toDouble(&ok);
+		double width = tagValue(OSM_KEY_WIDTH).toDouble(&ok);
 		if(ok)
 		{
             way.width = static_cast<uint32_t>(width * 1000);
 		}
-		//TR_INF << m_tags["width"] << way.width;
+		//TR_INF << tagValue(OSM_KEY_WIDTH) << way.width;
 	}
 
-	if(m_tags.contains("name"))
+	// temporary id, see closeOsm(), a way outside is only a ring part
+	if(hasTag(OSM_KEY_NAME) && inside)
+		way.name_id = names.add(tagValue(OSM_KEY_NAME));
+	if(hasTag(OSM_KEY_NAME_EN))
 	{
-		if(!name_map.contains(m_tags["name"]))
-		{
-			name_set set;
-			set.id = act_id;
-			set.number = 1;
-			name_map[m_tags["name"]] = set;
-			way.name_id = act_id;
-
-            //TR_INF << "Way: " << way.name_id << m_tags["name"];
-			act_id++;
-		}
-		else
-		{
-			name_map[m_tags["name"]].number++;
-			way.name_id = name_map[m_tags["name"]].id;
-		}
-	}
-	if(m_tags.contains("name:en"))
-	{
-		//TR_INF << "E" << m_tags["name:en"];
+		//TR_INF << "E" << tagValue(OSM_KEY_NAME_EN);
 	}
 
-	if(m_tags.contains("power"))
+	if(hasTag(OSM_KEY_POWER))
 	{
-		//TR_INF << "P" << m_tags["power"];
+		//TR_INF << "P" << tagValue(OSM_KEY_POWER);
 		// TODO: create network...
 		// 'line' -> way
 		// 'portal' -> way (node?)
@@ -477,108 +1264,310 @@ void TrImportOsmStream::closeWay(QMap<QString, name_set> & name_map, uint64_t &
 	uint64_t park_code = getParking();
 	if(park_code)
 	{
-		//TR_INF << "PARK" << HEX << park_code << (park_code >> 20) << m_tags["name"];
+		//TR_INF << "PARK" << HEX << park_code << (park_code >> 20) << tagValue(OSM_KEY_NAME);
 		way.parking = (park_code >> 20);
 	}
 	way.lanes = getLanes();
 	if(!way.lanes)
 		way.lanes = 1;
 
-	way.nd_id = (uint64_t*)malloc(sizeof(uint64_t) * m_way_reflist.size());
-	memset(way.nd_id, 0x00, sizeof(uint64_t) * m_way_reflist.size());
-	for(int i = 0; i<m_way_reflist.size(); i++)
+	if(m_id > 0)
 	{
-		way.nd_id[i] = m_way_reflist[i];
+		appendWay(way);
 	}
-	way.n_nd_id = m_way_reflist.size();
-	//memcpy(act_way->nd_id, world->tmp_id_buf,
-	//sizeof(uint64_t) * act_way->n_nd_id);
-
-	if(m_id > 0)
+	else
 	{
-		if(m_waylist.contains(m_id))
-		{
-			TR_WRN << "double use:" << m_id;
-		}
-		else
-		{
-			m_waylist[m_id] = way;
-		}
+		m_ref_count = m_ref_start;
 	}
 
 	m_id = 0;
-	m_tags.clear();
+	clearTags();
 }
 
 void TrImportOsmStream::closeOsm(World_t & world)
 {
-#ifdef TESTX
-	world.info.way.count = m_waylist.size();
-	if((world.ways = (Way_t *)malloc(sizeof(Way_t) * world.info.way.count)) == nullptr)
-    {
-        return;
-    }
-    memset(world.ways, 0x00, sizeof(Way_t) * world.info.way.count);
-#else
-    world.way_count = m_waylist.size();
-    if((world.ways = (Way_t *)malloc(sizeof(Way_t) * world.way_count)) == nullptr)
-    {
+	sortNodes();
+	sortWays();
+	if(m_pass == WayPass)
+	{
+		if(m_clip != nullptr)
+			TR_INF << "nodes inside:" << m_node_inside.count()
+					<< "bitset [KB]:" << (m_node_inside.memorySize() / 1024);
+		markNodes();
+		m_node_inside.clear();
+		m_way_inside.clear();
 		return;
 	}
-    memset(world.ways, 0x00, sizeof(Way_t) * world.way_count);
-#endif
 
-	int index = 0;
-	for (auto i = m_waylist.cbegin(), end = m_waylist.cend(); i != end; ++i)
-	{
-		Way_t way = i.value();
-		//memcpy(world.ways + (index * sizeof(Way_t)), &way, sizeof(Way_t));
-		world.ways[index].id = way.id;
-		world.ways[index].type = way.type;
-		world.ways[index].nd_id = way.nd_id;
-		world.ways[index].n_nd_id = way.n_nd_id;
-		world.ways[index].lanes = way.lanes;
-		world.ways[index].width = way.width;
-		world.ways[index].name_id = way.name_id;
-		world.ways[index].parking = way.parking;
-		index++;
+	// no copy, World_t is the owner now
+	if(m_node_count < m_node_size)
+	{
+		uint64_t * ids = static_cast<uint64_t *>(realloc(m_node_ids, sizeof(uint64_t) * (m_node_count ? m_node_count : 1)));
+		if(ids != nullptr)
+			m_node_ids = ids;
+		Coor_t * coor = static_cast<Coor_t *>(realloc(m_node_coor, sizeof(Coor_t) * (m_node_count ? m_node_count : 1)));
+		if(coor != nullptr)
+			m_node_coor = coor;
 	}
-#ifdef TESTX
-	world.info.node.count = m_nodelist.size();
-	if((world.nodes = (Point_t *)malloc(sizeof(Point_t) * world.info.node.count)) == nullptr)
+	if(m_poi_count < m_poi_size)
 	{
-		return;
+		Poi_t * pois = static_cast<Poi_t *>(realloc(m_pois, sizeof(Poi_t) * (m_poi_count ? m_poi_count : 1)));
+		if(pois != nullptr)
+			m_pois = pois;
 	}
-	memset(world.nodes, 0x00, sizeof(Point_t) * world.info.node.count);
+	if(m_way_count < m_way_size)
+	{
+		Way_t * ways = static_cast<Way_t *>(realloc(m_ways, sizeof(Way_t) * (m_way_count ? m_way_count : 1)));
+		if(ways != nullptr)
+			m_ways = ways;
+	}
+	if(m_ref_count < m_ref_size)
+	{
+		uint64_t * refs = static_cast<uint64_t *>(realloc(m_refs, sizeof(uint64_t) * (m_ref_count ? m_ref_count : 1)));
+		if(refs != nullptr)
+			m_refs = refs;
+	}
+#ifdef TESTX
+	world.info.node.count = m_node_count;
+	world.info.way.count = m_way_count;
 #else
-    world.node_count = m_nodelist.size();
-    if((world.nodes = (Point_t *)malloc(sizeof(Point_t) * world.node_count)) == nullptr)
-    {
-        return;
-    }
-    memset(world.nodes, 0x00, sizeof(Point_t) * world.node_count);
+	world.node_count = m_node_count;
+	world.way_count = m_way_count;
 #endif
-	index = 0;
-	for (auto i = m_nodelist.cbegin(), end = m_nodelist.cend(); i != end; ++i)
+	// the final name ids, sorted by name
+	world.m_names.finish();
+	for(size_t i = 0; i < m_way_count; i++)
+		m_ways[i].name_id = world.m_names.finalId(m_ways[i].name_id);
+	for(size_t i = 0; i < m_poi_count; i++)
+		m_pois[i].name_id = world.m_names.finalId(m_pois[i].name_id);
+
+	world.node_ids = m_node_ids;
+	world.node_coor = m_node_coor;
+	world.pois = m_pois;
+	world.poi_count = m_poi_count;
+	world.ways = m_ways;
+	world.nd_refs = m_refs;
+	world.nd_ref_count = m_ref_count;
+
+	TR_INF << "nodes:" << m_node_count << "POIs:" << m_poi_count << "ways:" << m_way_count
+			<< "refs:" << m_ref_count;
+
+	m_node_ids = nullptr;
+	m_node_coor = nullptr;
+	m_node_count = 0;
+	m_node_size = 0;
+	m_pois = nullptr;
+	m_poi_count = 0;
+	m_poi_size = 0;
+	m_ways = nullptr;
+	m_way_count = 0;
+	m_way_size = 0;
+	m_refs = nullptr;
+	m_ref_count = 0;
+	m_ref_size = 0;
+	m_ref_start = 0;
+}
+
+// end of the first pass: the ways without a type are not used by
+// TrImportOsm except as members of a multipolygon, only the nodes of
+// the other ways are needed, with a clip region only the ways inside
+void TrImportOsmStream::markNodes()
+{
+	size_t count = 0;
+
+	m_node_used.clear();
+	for(size_t i = 0; i < m_way_count; i++)
 	{
-		Point_t node = i.value();
-		world.nodes[index].id = node.id;
-		world.nodes[index].x = node.x;
-		world.nodes[index].y = node.y;
-		index++;
+		Way_t & way = m_ways[i];
+		// the ids stay in the ref array, it is freed as a whole
+		if((!m_rel_ways.contains(way.id)) && ((!way.type) ||
+				((m_clip != nullptr) && (!m_way_inside.contains(way.id)))))
+			continue;
+		const uint64_t * nd_id = m_refs + way.nd_ofs;
+		for(int j = 0; j < way.n_nd_id; j++)
+			m_node_used.set(nd_id[j]);
+		m_ways[count++] = way;
 	}
+	TR_INF << "used ways:" << count << "of" << m_way_count << "used nodes:" << m_node_used.count()
+			<< "bitset [KB]:" << (m_node_used.memorySize() / 1024);
+	m_way_count = count;
+	m_rel_ways.clear();
+}
 
-	TR_INF << "nodes:" << m_nodelist.size() << "ways:" << m_waylist.size();
+// one node inside is enough, the nodes outside are kept for the topology
+bool TrImportOsmStream::wayInside() const
+{
+	for(size_t i = m_ref_start; i < m_ref_count; i++)
+	{
+		if(m_node_inside.contains(m_refs[i]))
+			return true;
+	}
+	return false;
+}
+
+void TrImportOsmStream::appendNode(uint64_t id, int32_t x, int32_t y)
+{
+	if(m_node_count > 0)
+	{
+		uint64_t last = m_node_ids[m_node_count - 1];
+		if(id == last)
+		{
+			TR_WRN << "double use:" << id;
+			return;
+		}
+		if(id < last)
+			m_nodes_sorted = false;
+	}
+	if(m_node_count == m_node_size)
+	{
+		size_t size = m_node_size ? (m_node_size * 2) : OSM_STORE_START_SIZE;
+		uint64_t * ids = static_cast<uint64_t *>(realloc(m_node_ids, sizeof(uint64_t) * size));
+		if(ids == nullptr)
+		{
+			TR_ERR << "no memory for nodes:" << size;
+			return;
+		}
+		m_node_ids = ids;
+		Coor_t * coor = static_cast<Coor_t *>(realloc(m_node_coor, sizeof(Coor_t) * size));
+		if(coor == nullptr)
+		{
+			TR_ERR << "no memory for nodes:" << size;
+			return;
+		}
+		m_node_coor = coor;
+		m_node_size = size;
+	}
+	m_node_ids[m_node_count] = id;
+	m_node_coor[m_node_count].x = x;
+	m_node_coor[m_node_count].y = y;
+	m_node_count++;
 }
 
-void TrImportOsmStream::setNodeIds(World_t & world)
+void TrImportOsmStream::appendPoi(const Poi_t & poi)
 {
-	int index = 0;
-	for (auto i = m_nodelist.cbegin(), end = m_nodelist.cend(); i != end; ++i)
+	if(m_poi_count == m_poi_size)
 	{
-		world.nodes[index].id = i.key();
-		index++;
+		size_t size = m_poi_size ? (m_poi_size * 2) : (OSM_STORE_START_SIZE / 16);
+		Poi_t * pois = static_cast<Poi_t *>(realloc(m_pois, sizeof(Poi_t) * size));
+		if(pois == nullptr)
+		{
+			TR_ERR << "no memory for POIs:" << size;
+			return;
+		}
+		m_pois = pois;
+		m_poi_size = size;
 	}
+	m_pois[m_poi_count++] = poi;
+}
+
+void TrImportOsmStream::appendWay(const Way_t & way)
+{
+	if(m_way_count > 0)
+	{
+		uint64_t last = m_ways[m_way_count - 1].id;
+		if(way.id == last)
+		{
+			TR_WRN << "double use:" << way.id;
+			m_ref_count = way.nd_ofs;
+			return;
+		}
+		if(way.id < last)
+			m_ways_sorted = false;
+	}
+	if(m_way_count == m_way_size)
+	{
+		size_t size = m_way_size ? (m_way_size * 2) : OSM_STORE_START_SIZE;
+		Way_t * ways = static_cast<Way_t *>(realloc(m_ways, sizeof(Way_t) * size));
+		if(ways == nullptr)
+		{
+			TR_ERR << "no memory for ways:" << size;
+			m_ref_count = way.nd_ofs;
+			return;
+		}
+		m_ways = ways;
+		m_way_size = size;
+	}
+	m_ways[m_way_count++] = way;
+}
+
+void TrImportOsmStream::appendRef(uint64_t ref)
+{
+	if(m_ref_count == m_ref_size)
+	{
+		size_t size = m_ref_size ? (m_ref_size * 2) : (OSM_STORE_START_SIZE * 8);
+		uint64_t * refs = static_cast<uint64_t *>(realloc(m_refs, sizeof(uint64_t) * size));
+		if(refs == nullptr)
+		{
+			TR_ERR << "no memory for node refs:" << size;
+			return;
+		}
+		m_refs = refs;
+		m_ref_size = size;
+	}
+	m_refs[m_ref_count++] = ref;
+}
+
+// only for unsorted files, the first element of an id is used
+void TrImportOsmStream::sortNodes()
+{
+	if(m_nodes_sorted)
+		return;
+
+	// the two arrays are sorted together in a temporary one
+	struct NodeSort
+	{
+		uint64_t id;
+		Coor_t coor;
+	};
+	NodeSort * sort = static_cast<NodeSort *>(malloc(sizeof(NodeSort) * (m_node_count ? m_node_count : 1)));
+	if(sort == nullptr)
+	{
+		TR_ERR << "no memory to sort the nodes:" << m_node_count;
+		return;
+	}
+	for(size_t i = 0; i < m_node_count; i++)
+	{
+		sort[i].id = m_node_ids[i];
+		sort[i].coor = m_node_coor[i];
+	}
+	std::stable_sort(sort, sort + m_node_count,
+			[](const NodeSort & a, const NodeSort & b) { return a.id < b.id; });
+	size_t count = 0;
+	for(size_t i = 0; i < m_node_count; i++)
+	{
+		if((count > 0) && (m_node_ids[count - 1] == sort[i].id))
+		{
+			TR_WRN << "double use:" << sort[i].id;
+			continue;
+		}
+		m_node_ids[count] = sort[i].id;
+		m_node_coor[count] = sort[i].coor;
+		count++;
+	}
+	free(sort);
+	m_node_count = count;
+	m_nodes_sorted = true;
+}
+
+void TrImportOsmStream::sortWays()
+{
+	if(m_ways_sorted)
+		return;
+
+	std::stable_sort(m_ways, m_ways + m_way_count,
+			[](const Way_t & a, const Way_t & b) { return a.id < b.id; });
+	size_t count = 0;
+	for(size_t i = 0; i < m_way_count; i++)
+	{
+		if((count > 0) && (m_ways[count - 1].id == m_ways[i].id))
+		{
+			TR_WRN << "double use:" << m_ways[i].id;
+			continue;
+		}
+		m_ways[count++] = m_ways[i];
+	}
+	m_way_count = count;
+	m_ways_sorted = true;
 }
 
 void TrImportOsmStream::addRelation(const Relation & rel)
@@ -586,7 +1575,7 @@ void TrImportOsmStream::addRelation(const Relation & rel)
 	Rel_t crel;
 	crel.flags = rel.m_flags;
 	crel.r_count = rel.m_members.size();
-	crel.id = 0;
+	crel.id = rel.m_id;
     if((crel.members = (RelMember_t *)malloc(sizeof(RelMember_t) * crel.r_count)) == nullptr)
 		return;
 	for(size_t i = 0; i<crel.r_count; i++)
@@ -596,34 +1585,67 @@ void TrImportOsmStream::addRelation(const Relation & rel)
 	m_rellist.append(crel);
 }
 
+// for "multipolygon" -> "face" object
+void TrImportOsmStream::checkRelation(Relation & rel)
+{
+	if(m_clip != nullptr)
+	{
+		// at least one member inside, the members outside are kept for the
+		// rings like the nodes outside of a crossing way
+		bool inside = false;
+		for(int i = 0; (i < rel.m_members.size()) && (!inside); i++)
+			inside = m_way_inside.contains(rel.m_members[i].id);
+		if(!inside)
+			return;
+	}
+	if(rel.isMultiPolyRing() > 0)
+	{
+		rel.resetPolyRing(m_ways, m_way_count);
+		addRelation(rel);
+		for(int i = 0; i < rel.m_members.size(); i++)
+			m_rel_ways.set(rel.m_members[i].id);
+	}
+}
+
+static constexpr OsmTagEntry s_highway_tags[] =
+{
+	{"service",            0x0000000000000009},
+	{"escape",             0x0000000000000009},
+	{"bus_guideway",       0x0000000000000009},
+	{"track",              0x000000000000000A},
+	{"path",               0x000000000000000B},
+	{"bridleway",          0x000000000000000B},
+	{"footway",            0x000000000000000F},
+	{"cycleway",           0x000000000000000C},
+	{"steps",              0x000000000000000D},
+	{"pedestrian",         0x000000000000000E},
+	{"motorway",           0x0000000000000001},
+	{"trunk",              0x0000000000000002},
+	{"primary",            0x0000000000000003},
+	{"secondary",          0x0000000000000004},
+	{"tertiary",           0x0000000000000005},
+	{"unclassified",       0x0000000000000006},
+	{"residential",        0x0000000000000007},
+	{"living_street",      0x0000000000000008},
+	{"motorway_link",      FLAG_RAMP | 0x0000000000000001},
+	{"trunk_link",         FLAG_RAMP | 0x0000000000000002},
+	{"primary_link",       FLAG_RAMP | 0x0000000000000003},
+	{"secondary_link",     FLAG_RAMP | 0x0000000000000004},
+	{"tertiary_link",      FLAG_RAMP | 0x0000000000000005},
+	{"unclassified_link",  FLAG_RAMP | 0x0000000000000006},
+	{"residential_link",   FLAG_RAMP | 0x0000000000000007},
+	{"living_street_link", FLAG_RAMP | 0x0000000000000008},
+};
+OSM_TAG_TABLE(s_highway, 64, 0x811CA13EU)
+
 uint64_t TrImportOsmStream::getClass(const QString & value)
 {
 	uint64_t ret = 0;
 
-	if(value == "service")
-		return 0x0000000000000009;
-	if(value == "escape")
-		return 0x0000000000000009;
-	if(value == "bus_guideway")
-		return 0x0000000000000009;
-
-	if(value == "track")
-		return 0x000000000000000A;
-
-	if(value == "path")
-		return 0x000000000000000B;
-	if(value == "bridleway")
-		return 0x000000000000000B;
-	if(value == "footway")
-		return 0x000000000000000F;
-	if(value == "cycleway")
-		return 0x000000000000000C;
-	if(value == "steps")
-		return 0x000000000000000D;
-
-	if(value == "pedestrian")
-		return 0x000000000000000E;
+	if(osmTagFind(s_highway_tags, s_highway_slots, s_highway_seed, value, ret))
+		return ret;
 
+	// other values with a known start, e.g. 'primary_construction'
 	if(value.endsWith("_link"))
 	{
 		ret |= FLAG_RAMP;
@@ -685,22 +1707,22 @@ uint64_t TrImportOsmStream::getLanes()
 	uint64_t lane = 0;
 	bool ok = false;
 
-	if(m_tags.contains("lanes"))
+	if(hasTag(OSM_KEY_LANES))
 	{
-		lane = m_tags["lanes"].toULongLong(&ok);
+		lane = tagValue(OSM_KEY_LANES).toULongLong(&ok);
 		if(ok)
 			ret |= (lane & 0x0000000000000007);
 		//m_id = attributes.value("id").toULongLong(&ok);
 	}
-	if(m_tags.contains("lanes:forward"))
+	if(hasTag(OSM_KEY_LANES_FORWARD))
 	{
-		lane = m_tags["lanes:forward"].toULongLong(&ok);
+		lane = tagValue(OSM_KEY_LANES_FORWARD).toULongLong(&ok);
 		if(ok)
 			ret |= (lane << 16);
 	}
-	if(m_tags.contains("lanes:backward"))
+	if(hasTag(OSM_KEY_LANES_BACKWARD))
 	{
-		lane = m_tags["lanes:backward"].toULongLong(&ok);
+		lane = tagValue(OSM_KEY_LANES_BACKWARD).toULongLong(&ok);
 		if(ok)
 			ret |= (lane << 24);
 	}
@@ -805,15 +1827,15 @@ uint64_t TrImportOsmStream::parkingTest(const QString & part, const QString & va
 // exp: <tag k='parking:left:orientation' v='parallel' />
 uint64_t TrImportOsmStream::getParking()
 {
-	QMapIterator<QString, QString> i(m_tags);
 	uint64_t ret = 0;
 	uint64_t mode = 0;
-	while (i.hasNext())
+	for(int i = 0; i < m_tag_count; i++)
 	{
-		i.next();
-		if(i.key().startsWith("parking"))
+		// the known keys, the others are "parking*"
+		if(m_tag_list[i].key >= OSM_KEY_COUNT)
 		{
-			QStringList plist = i.key().split(':');
+			const QString & value = tagString(m_tag_list[i].value);
+			QStringList plist = m_pool.string(m_tag_list[i].key).split(':');
 			if(plist.size() > 1)
 			{
 				mode = 0;
@@ -823,14 +1845,14 @@ uint64_t TrImportOsmStream::getParking()
 					{
 						if(plist[2] == "restriction")
 						{
-							ret |= parkingRes(i.value(), mode);
+							ret |= parkingRes(value, mode);
 						}
-						ret |= parkingTest(plist[2], i.value(), mode);
+						ret |= parkingTest(plist[2], value, mode);
 					}
 					else
 					{
 						// "no", "no_parking", "no_stopping"
-						if(i.value().startsWith("no"))
+						if(value.startsWith("no"))
 						{
 							if(mode & 0x0000000000000001)
 								ret |= V_PARK_NO_R;
@@ -843,7 +1865,7 @@ uint64_t TrImportOsmStream::getParking()
 				{
 				}
 			}
-			//TR_INF << plist << i.value() << HEX << mode << ret;
+			//TR_INF << plist << value << HEX << mode << ret;
 		}
 	}
 	return ret;
@@ -48,33 +48,106 @@
 #include "osm_types.h"
 #include "tr_point.h"
 
+#include "osm_block.h"
 #include "tr_import_osm_rel.h"
+#include "tr_osm_clip.h"
+#include "tr_osm_id_set.h"
+#include "tr_osm_inflate.h"
+#include "tr_osm_tag_pool.h"
+#include "tr_osm_xml_scan.h"
 
 class TrImportOsmStream : public TrGeoObject
 {
+public:
+	// element filter for the import in two passes
+	enum Pass
+	{
+		AllPass = 0,
+		// ways and relations, the used nodes are marked at the end,
+		// with a clip region also the nodes inside
+		WayPass,
+		// only the marked nodes and the POIs
+		NodePass
+	};
+
 private:
 	QString m_filename;
 	//<tag k="highway" v="motorway"/>
-	QMap<QString, QString> m_tags;
+	// tags of the actual element, only the keys used by the import
+	TrOsmTagPool m_pool;
+	QVector<OsmTag_t> m_tag_list;
+	int m_tag_count;
+	// name, width, lanes and values outside of ASCII
+	QVector<QString> m_tag_text;
+	int m_text_count;
 	uint64_t m_id;
-	TrPoint m_point;
-	QMap<uint64_t, Point_t> m_nodelist;
-	QMap<uint64_t, Way_t> m_waylist;
+	// fixed point coordinates like Point_t
+	TrPoint32 m_coor;
+	// flat stores in file order, closeOsm gives them to World_t
+	uint64_t * m_node_ids;
+	Coor_t * m_node_coor;
+	size_t m_node_count;
+	size_t m_node_size;
+	Poi_t * m_pois;
+	size_t m_poi_count;
+	size_t m_poi_size;
+	Way_t * m_ways;
+	size_t m_way_count;
+	size_t m_way_size;
+	// node ids of the ways, the actual way starts at 'm_ref_start'
+	uint64_t * m_refs;
+	size_t m_ref_count;
+	size_t m_ref_size;
+	size_t m_ref_start;
+	// the ids are ascending up to now, OSM files are sorted
+	bool m_nodes_sorted;
+	bool m_ways_sorted;
+
+	Pass m_pass;
+	TrOsmIdSet m_node_used;
+	const TrOsmClip * m_clip;
+	// way pass with a clip region, the nodes come before the ways
+	TrOsmIdSet m_node_inside;
+	TrOsmIdSet m_way_inside;
+	// member ways of the multipolygons, kept without a type or outside
+	TrOsmIdSet m_rel_ways;
 	QVector<Rel_t> m_rellist;
-	QVector<uint64_t> m_way_reflist;
 
 	void readTag(const QXmlStreamAttributes &attributes);
 	void readNodePoint(const QXmlStreamAttributes &attributes);
 	void readWay(const QXmlStreamAttributes &attributes);
 
-	void closeNode(QMap<QString, name_set> & name_map,
-			uint64_t & act_id, QMap<uint64_t, QString> & n_map);
-	void closeWay(QMap<QString, name_set> & name_map, uint64_t & act_id);
+	void readTag(const TrOsmXmlScan & scan);
+	void scanXml(TrOsmXmlScan & xml, World_t & world);
+
+	template <typename C> uint32_t tagKey(const C * key, int len);
+	void addBlockTag(const OsmBlock & block, uint32_t key, uint32_t value);
+	int findTag(uint32_t key) const;
+	bool hasTag(uint32_t key) const;
+	const QString & tagValue(uint32_t key) const;
+	const QString & tagString(uint32_t value) const;
+	void appendTag(uint32_t key, uint32_t value);
+	uint32_t appendText(const QString & text);
+	void clearTags();
+	void readNodePoint(const TrOsmXmlScan & scan);
+	void readWay(const TrOsmXmlScan & scan);
+
+	void closeNode(TrOsmNameDict & names);
+	void closeWay(TrOsmNameDict & names);
 	void closeOsm(World_t & world);
 
+	void appendNode(uint64_t id, int32_t x, int32_t y);
+	void appendPoi(const Poi_t & poi);
+	void appendWay(const Way_t & way);
+	void appendRef(uint64_t ref);
+	void sortNodes();
+	void sortWays();
+	void markNodes();
+	bool wayInside() const;
+
 	void addRelation(const Relation & rel);
+	void checkRelation(Relation & rel);
 
-	uint64_t getClass(const QString & value);
 	uint64_t getDir(const QString & value);
 	uint64_t getLanes();
 	bool parkingMode(const QString & part, uint64_t & code);
@@ -88,12 +161,45 @@ public:
 	virtual ~TrImportOsmStream();
 
 	bool osmRead(World_t & world);
+	bool osmReadMapped(World_t & world);
+	// .osm.gz or .osm.bz2 with TrOsmXmlScan, see TrOsmInflate
+	bool osmReadInflate(World_t & world);
+
+	// the file is read once for each pass, World_t is filled by the last
+	void setPass(Pass pass);
+	// the region of all passes, nullptr: no clipping
+	void setClip(const TrOsmClip * clip);
+
+	// element interface, used by the readers of the binary formats
+	void beginOsm(World_t & world);
+	void beginNode(uint64_t id, int32_t x, int32_t y);
+	void beginWay(uint64_t id);
+	void addTag(const QString & key, const QString & value);
+	// 'key' from tagKey(), 'xml': the value can have entities
+	void addTag(uint32_t key, const OsmView_t & value, bool xml);
+	void addNodeRef(uint64_t ref);
+	void endNode(World_t & world);
+	void endWay(World_t & world);
+	void endRelation(TrImportOsmRel & rel_read, Relation & rel);
+	void endOsm(World_t & world);
+
+	// decoded in parallel, added in the order of 'chunks'
+	void addBlock(const OsmBlock & block, World_t & world);
+	bool addBlocks(const QVector<OsmChunk_t> & chunks, OsmBlock (*decode)(const OsmChunk_t &),
+			World_t & world, QString & error);
+
+	// the mapped file is split on element starts, see TR_IMPORT_PARALLEL
+	bool osmReadParallel(World_t & world);
+	static OsmBlock decodeChunk(const OsmChunk_t & chunk);
+	// key id for the workers: OsmTagKey, OSM_KEY_COUNT for a key of
+	// the pool (tagKey), OSM_TAG_NONE for a key which is not used
+	static uint32_t blockKey(const OsmView_t & key);
 
-	void setNodeIds(World_t & world);
-
-	QMap<uint64_t, Point_t> & getNodeMap();
 	QVector<Rel_t> & getRelationList();
 
+	// class of a "highway" value, the fallback checks the start of the value
+	static uint64_t getClass(const QString & value);
+
 	virtual bool init(const TrZoomMap& zoom, uint64_t contr, TrGeoObject* obj);
 	virtual bool setSurroundingRect();
 
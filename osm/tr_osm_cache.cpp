@@ -0,0 +1,372 @@
+/******************************************************************
+ *
+ * @short	binary cache of the parsed OSM file
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmCache
+ * superclass:	---
+ * modul:	tr_osm_cache.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+
+
+#include "tr_osm_cache.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+
+#include <string.h>
+
+static uint64_t osmCacheAlign(uint64_t pos)
+{
+	return (pos + OSM_CACHE_ALIGN - 1) & ~static_cast<uint64_t>(OSM_CACHE_ALIGN - 1);
+}
+
+TrOsmCache::TrOsmCache()
+	: m_map(nullptr)
+	, m_max_size(OSM_CACHE_MAX_SIZE)
+{
+}
+
+TrOsmCache::~TrOsmCache()
+{
+	if(m_map != nullptr)
+		m_file.unmap(m_map);
+}
+
+void TrOsmCache::setMaxSize(qint64 size)
+{
+	m_max_size = size;
+}
+
+bool TrOsmCache::isMapped() const
+{
+	return (m_map != nullptr);
+}
+
+const QVector<Rel_t> & TrOsmCache::getRelationList() const
+{
+	return m_relations;
+}
+
+// one file for each path
+QString TrOsmCache::cacheName(const QString & filename)
+{
+	QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	QByteArray path = QFileInfo(filename).absoluteFilePath().toUtf8();
+	QByteArray key = QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex();
+	return dir + "/osm/" + QString::fromLatin1(key) + ".trc";
+}
+
+// size, time and a hash of some parts, a hash of the whole file
+// would take nearly as long as the parse
+bool TrOsmCache::sourceKey(const QString & filename, OsmCacheHeader_t & header)
+{
+	QFile file(filename);
+	if(!file.open(QFile::ReadOnly))
+		return false;
+
+	QFileInfo info(file);
+	header.src_size = static_cast<uint64_t>(file.size());
+	header.src_mtime = info.lastModified().toMSecsSinceEpoch();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(reinterpret_cast<const char *>(&header.src_size), sizeof(header.src_size));
+	qint64 size = file.size();
+	qint64 step = size / (OSM_CACHE_BLOCKS + 1);
+	for(int i = 0; i <= OSM_CACHE_BLOCKS + 1; i++)
+	{
+		qint64 pos = i * step;
+		if(i == (OSM_CACHE_BLOCKS + 1))
+			pos = size - OSM_CACHE_SAMPLE;
+		if(pos < 0)
+			pos = 0;
+		if(!file.seek(pos))
+			return false;
+		hash.addData(file.read(OSM_CACHE_SAMPLE));
+	}
+	QByteArray res = hash.result();
+	memcpy(header.src_hash, res.constData(), sizeof(header.src_hash));
+	return true;
+}
+
+bool TrOsmCache::writeArray(QIODevice & dev, const void * data, uint64_t size)
+{
+	static const char zero[OSM_CACHE_ALIGN] = {};
+
+	qint64 pad = static_cast<qint64>(osmCacheAlign(static_cast<uint64_t>(dev.pos())) - static_cast<uint64_t>(dev.pos()));
+	if((pad > 0) && (dev.write(zero, pad) != pad))
+		return false;
+	if(size == 0)
+		return true;
+	return (dev.write(static_cast<const char *>(data), static_cast<qint64>(size)) == static_cast<qint64>(size));
+}
+
+bool TrOsmCache::load(const QString & filename, uint64_t mode, World_t & world)
+{
+	OsmCacheHeader_t key;
+	OsmCacheHeader_t header;
+
+	m_file.setFileName(cacheName(filename));
+	if(!m_file.exists())
+		return false;
+	if(!m_file.open(QFile::ReadOnly) || (m_file.size() < static_cast<qint64>(sizeof(header))) ||
+			(m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header))))
+	{
+		TR_WRN << "cache not readable" << m_file.fileName();
+		m_file.close();
+		return false;
+	}
+
+	if((memcmp(header.magic, OSM_CACHE_MAGIC, sizeof(header.magic)) != 0) ||
+			(header.version != OSM_CACHE_VERSION) ||
+			(header.layout != ((sizeof(Poi_t) << 16) | sizeof(Way_t))) || (header.mode != mode))
+	{
+		TR_INF << "old cache" << m_file.fileName();
+		m_file.close();
+		return false;
+	}
+	if(!sourceKey(filename, key) || (key.src_size != header.src_size) ||
+			(key.src_mtime != header.src_mtime) ||
+			(memcmp(key.src_hash, header.src_hash, sizeof(key.src_hash)) != 0))
+	{
+		TR_INF << "cache of a changed file" << m_file.fileName();
+		m_file.close();
+		return false;
+	}
+
+	uint64_t size = static_cast<uint64_t>(m_file.size());
+	if(((header.node_ofs + header.node_count * sizeof(uint64_t)) > size) ||
+			((header.coor_ofs + header.node_count * sizeof(Coor_t)) > size) ||
+			((header.poi_ofs + header.poi_count * sizeof(Poi_t)) > size) ||
+			((header.way_ofs + header.way_count * sizeof(Way_t)) > size) ||
+			((header.ref_ofs + header.ref_count * sizeof(uint64_t)) > size) ||
+			((header.rel_ofs + header.rel_count * sizeof(OsmCacheRel_t)) > size) ||
+			((header.member_ofs + header.member_count * sizeof(RelMember_t)) > size) ||
+			((header.name_ofs + header.name_size) > size))
+	{
+		TR_WRN << "cache truncated" << m_file.fileName();
+		m_file.close();
+		return false;
+	}
+
+	// private: changes of the arrays don't go to the file
+	m_map = m_file.map(0, m_file.size(), QFileDevice::MapPrivateOption);
+	if(m_map == nullptr)
+	{
+		TR_WRN << "cache not mapped" << m_file.errorString();
+		m_file.close();
+		return false;
+	}
+
+	const OsmCacheRel_t * rels = reinterpret_cast<const OsmCacheRel_t *>(m_map + header.rel_ofs);
+	RelMember_t * members = reinterpret_cast<RelMember_t *>(m_map + header.member_ofs);
+	m_relations.clear();
+	for(uint64_t i = 0; i < header.rel_count; i++)
+	{
+		if((rels[i].member + rels[i].r_count) > header.member_count)
+			break;
+		Rel_t rel;
+		rel.id = rels[i].id;
+		rel.flags = rels[i].flags;
+		rel.r_count = rels[i].r_count;
+		rel.members = members + rels[i].member;
+		m_relations.append(rel);
+	}
+
+	QByteArray names = QByteArray::fromRawData(reinterpret_cast<const char *>(m_map + header.name_ofs),
+			static_cast<int>(header.name_size));
+	QDataStream stream(names);
+	// in the order of the final ids
+	world.m_names.clear();
+	for(uint64_t i = 0; (i < header.name_count) && (stream.status() == QDataStream::Ok); i++)
+	{
+		QString name;
+		quint32 number = 0;
+		stream >> name >> number;
+		world.m_names.appendName(name, number);
+	}
+	if(stream.status() != QDataStream::Ok)
+	{
+		TR_WRN << "cache names broken" << m_file.fileName();
+		m_file.unmap(m_map);
+		m_map = nullptr;
+		m_file.close();
+		return false;
+	}
+
+	world.node_count = header.node_count;
+	world.node_ids = reinterpret_cast<uint64_t *>(m_map + header.node_ofs);
+	world.node_coor = reinterpret_cast<Coor_t *>(m_map + header.coor_ofs);
+	world.poi_count = header.poi_count;
+	world.pois = reinterpret_cast<Poi_t *>(m_map + header.poi_ofs);
+	world.way_count = header.way_count;
+	world.ways = reinterpret_cast<Way_t *>(m_map + header.way_ofs);
+	world.nd_ref_count = header.ref_count;
+	world.nd_refs = reinterpret_cast<uint64_t *>(m_map + header.ref_ofs);
+
+	TR_INF << "cache" << m_file.fileName() << "nodes:" << header.node_count << "POIs:" << header.poi_count
+			<< "ways:" << header.way_count << "relations:" << m_relations.size();
+	return true;
+}
+
+bool TrOsmCache::save(const QString & filename, uint64_t mode, const World_t & world,
+		const QVector<Rel_t> & relations)
+{
+	OsmCacheHeader_t header;
+
+	memset(&header, 0x00, sizeof(header));
+	if(!sourceKey(filename, header))
+		return false;
+	memcpy(header.magic, OSM_CACHE_MAGIC, sizeof(header.magic));
+	header.version = OSM_CACHE_VERSION;
+	header.layout = (sizeof(Poi_t) << 16) | sizeof(Way_t);
+	header.mode = mode;
+	header.name_count = static_cast<uint64_t>(world.m_names.size());
+
+	QVector<OsmCacheRel_t> rels;
+	uint64_t n_member = 0;
+	for(int i = 0; i < relations.size(); i++)
+	{
+		OsmCacheRel_t rel;
+		rel.id = relations[i].id;
+		rel.flags = relations[i].flags;
+		rel.member = n_member;
+		rel.r_count = relations[i].r_count;
+		rel.reserved = 0;
+		rels.append(rel);
+		n_member += relations[i].r_count;
+	}
+
+	QByteArray names;
+	QDataStream stream(&names, QIODevice::WriteOnly);
+	for(uint64_t id = 1; id <= header.name_count; id++)
+	{
+		stream << world.m_names.name(id) << static_cast<quint32>(world.m_names.number(id));
+	}
+
+	// the layout first, the arrays follow in this order
+	uint64_t pos = sizeof(header);
+	header.node_count = world.node_count;
+	header.node_ofs = osmCacheAlign(pos);
+	pos = header.node_ofs + header.node_count * sizeof(uint64_t);
+	header.coor_ofs = osmCacheAlign(pos);
+	pos = header.coor_ofs + header.node_count * sizeof(Coor_t);
+	header.poi_count = world.poi_count;
+	header.poi_ofs = osmCacheAlign(pos);
+	pos = header.poi_ofs + header.poi_count * sizeof(Poi_t);
+	header.way_count = world.way_count;
+	header.way_ofs = osmCacheAlign(pos);
+	pos = header.way_ofs + header.way_count * sizeof(Way_t);
+	header.ref_count = world.nd_ref_count;
+	header.ref_ofs = osmCacheAlign(pos);
+	pos = header.ref_ofs + header.ref_count * sizeof(uint64_t);
+	header.rel_count = static_cast<uint64_t>(rels.size());
+	header.rel_ofs = osmCacheAlign(pos);
+	pos = header.rel_ofs + header.rel_count * sizeof(OsmCacheRel_t);
+	header.member_count = n_member;
+	header.member_ofs = osmCacheAlign(pos);
+	pos = header.member_ofs + header.member_count * sizeof(RelMember_t);
+	header.name_size = static_cast<uint64_t>(names.size());
+	header.name_ofs = osmCacheAlign(pos);
+	pos = header.name_ofs + header.name_size;
+	if(static_cast<qint64>(pos) > m_max_size)
+	{
+		TR_INF << "no cache, size [MB]:" << (pos / (1024 * 1024));
+		return false;
+	}
+
+	QString name = cacheName(filename);
+	if(!QDir().mkpath(QFileInfo(name).path()))
+	{
+		TR_WRN << "no cache directory" << QFileInfo(name).path();
+		return false;
+	}
+	// written to a temporary file, renamed by 'commit'
+	QSaveFile file(name);
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		TR_WRN << "cache not written" << file.errorString();
+		return false;
+	}
+	bool ok = (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)));
+	ok = ok && writeArray(file, world.node_ids, header.node_count * sizeof(uint64_t));
+	ok = ok && writeArray(file, world.node_coor, header.node_count * sizeof(Coor_t));
+	ok = ok && writeArray(file, world.pois, header.poi_count * sizeof(Poi_t));
+	ok = ok && writeArray(file, world.ways, header.way_count * sizeof(Way_t));
+	ok = ok && writeArray(file, world.nd_refs, header.ref_count * sizeof(uint64_t));
+	ok = ok && writeArray(file, rels.constData(), header.rel_count * sizeof(OsmCacheRel_t));
+	for(int i = 0; ok && (i < relations.size()); i++)
+	{
+		// the members of all relations in one array
+		uint64_t size = relations[i].r_count * sizeof(RelMember_t);
+		ok = (i == 0) ? writeArray(file, relations[i].members, size) :
+				(file.write(reinterpret_cast<const char *>(relations[i].members),
+						static_cast<qint64>(size)) == static_cast<qint64>(size));
+	}
+	if(ok && relations.isEmpty())
+		ok = writeArray(file, nullptr, 0);
+	ok = ok && writeArray(file, names.constData(), header.name_size);
+	if(!ok || !file.commit())
+	{
+		TR_WRN << "cache not written" << file.errorString();
+		file.cancelWriting();
+		return false;
+	}
+	TR_INF << "cache written" << name;
+	trim(name, static_cast<qint64>(pos));
+	return true;
+}
+
+// the oldest snapshots first, 'keep' is the new one
+void TrOsmCache::trim(const QString & keep, qint64 keep_size)
+{
+	QDir dir(QFileInfo(keep).path());
+	QFileInfoList list = dir.entryInfoList(QStringList() << "*.trc", QDir::Files, QDir::Time);
+	qint64 total = keep_size;
+	for(int i = 0; i < list.size(); i++)
+	{
+		if(list[i].absoluteFilePath() == QFileInfo(keep).absoluteFilePath())
+			continue;
+		total += list[i].size();
+		if(total <= m_max_size)
+			continue;
+		total -= list[i].size();
+		TR_INF << "cache removed" << list[i].fileName();
+		QFile::remove(list[i].absoluteFilePath());
+	}
+}
@@ -0,0 +1,142 @@
+/******************************************************************
+ *
+ * @short	binary cache of the parsed OSM file
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmCache
+ * superclass:	---
+ * modul:	tr_osm_cache.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+
+#ifndef TR_OSM_CACHE_H
+#define TR_OSM_CACHE_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+#include "osm_load.h"
+#include "osm_types.h"
+
+#define OSM_CACHE_MAGIC     "TROSMC01"
+// increment with every change of the layout or of the parser result
+#define OSM_CACHE_VERSION   4
+// start of the arrays in the file
+#define OSM_CACHE_ALIGN     64
+// content hash: start, end and some blocks between
+#define OSM_CACHE_SAMPLE    (1024 * 1024)
+#define OSM_CACHE_BLOCKS    14
+// all snapshots together, the oldest ones are removed
+#define OSM_CACHE_MAX_SIZE  (Q_INT64_C(4) * 1024 * 1024 * 1024)
+
+typedef struct
+{
+	char magic[8];
+	uint32_t version;
+	// sizeof(Poi_t) << 16 | sizeof(Way_t)
+	uint32_t layout;
+	// import flags which change the result
+	uint64_t mode;
+
+	// source file
+	uint64_t src_size;
+	int64_t src_mtime;
+	uint8_t src_hash[20];
+	uint32_t reserved;
+
+	// final ids of TrOsmNameDict
+	uint64_t name_count;
+	uint64_t node_count;
+	// ids and coordinates
+	uint64_t node_ofs;
+	uint64_t coor_ofs;
+	uint64_t poi_count;
+	uint64_t poi_ofs;
+	uint64_t way_count;
+	uint64_t way_ofs;
+	uint64_t ref_count;
+	uint64_t ref_ofs;
+	uint64_t rel_count;
+	uint64_t rel_ofs;
+	uint64_t member_count;
+	uint64_t member_ofs;
+	// names and numbers, QDataStream
+	uint64_t name_size;
+	uint64_t name_ofs;
+}OsmCacheHeader_t;
+
+// Rel_t without the pointer
+typedef struct
+{
+	uint64_t id;
+	uint64_t flags;
+	uint64_t member;
+	uint32_t r_count;
+	uint32_t reserved;
+}OsmCacheRel_t;
+
+// Snapshot of World_t after the parse, one file for each source file in
+// the cache directory (TR_IMPORT_CACHE). A valid snapshot is mapped (copy on write), the
+// arrays of World_t point into the mapping as long as this object exists.
+class TrOsmCache
+{
+private:
+	QFile m_file;
+	uchar * m_map;
+	QVector<Rel_t> m_relations;
+	qint64 m_max_size;
+
+	static QString cacheName(const QString & filename);
+	void trim(const QString & keep, qint64 keep_size);
+	static bool sourceKey(const QString & filename, OsmCacheHeader_t & header);
+	static bool writeArray(QIODevice & dev, const void * data, uint64_t size);
+
+public:
+	TrOsmCache();
+	virtual ~TrOsmCache();
+
+	// false for a missing, old or other snapshot
+	bool load(const QString & filename, uint64_t mode, World_t & world);
+	bool save(const QString & filename, uint64_t mode, const World_t & world,
+			const QVector<Rel_t> & relations);
+
+	// limit of the cache directory, default OSM_CACHE_MAX_SIZE
+	void setMaxSize(qint64 size);
+
+	// World_t uses the mapping, don't free the arrays
+	bool isMapped() const;
+	const QVector<Rel_t> & getRelationList() const;
+};
+
+#endif // TR_OSM_CACHE_H
@@ -0,0 +1,206 @@
+/******************************************************************
+ *
+ * @short	clip region of the OSM import
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmClip
+ * superclass:	---
+ * modul:	tr_osm_clip.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+
+
+#include "tr_osm_clip.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qtextstream.h>
+
+#include <math.h>
+
+TrOsmClip::TrOsmClip()
+	: m_valid(false)
+{
+	clear();
+}
+
+TrOsmClip::~TrOsmClip()
+{
+}
+
+void TrOsmClip::clear()
+{
+	m_valid = false;
+	m_min.x = INT32_MIN;
+	m_min.y = INT32_MIN;
+	m_max.x = INT32_MAX;
+	m_max.y = INT32_MAX;
+	m_poly.clear();
+}
+
+bool TrOsmClip::isValid() const
+{
+	return m_valid;
+}
+
+// TrPoint (factor TR_COOR_FACTOR) to Point_t
+int32_t TrOsmClip::toFix(double val)
+{
+	return static_cast<int32_t>(lround(val * 100.0));
+}
+
+void TrOsmClip::setRect(const TrPoint & min, const TrPoint & max)
+{
+	clear();
+	m_min.x = toFix(qMin(min.x, max.x));
+	m_min.y = toFix(qMin(min.y, max.y));
+	m_max.x = toFix(qMax(min.x, max.x));
+	m_max.y = toFix(qMax(min.y, max.y));
+	m_valid = true;
+}
+
+bool TrOsmClip::setPolygon(const QVector<TrPoint> & poly)
+{
+	clear();
+	if(poly.size() < 3)
+	{
+		TR_WRN << "clip polygon with" << poly.size() << "points";
+		return false;
+	}
+	m_min.x = INT32_MAX;
+	m_min.y = INT32_MAX;
+	m_max.x = INT32_MIN;
+	m_max.y = INT32_MIN;
+	for(int i = 0; i < poly.size(); i++)
+	{
+		TrPoint32 pt;
+		pt.x = toFix(poly[i].x);
+		pt.y = toFix(poly[i].y);
+		m_min.x = qMin(m_min.x, pt.x);
+		m_min.y = qMin(m_min.y, pt.y);
+		m_max.x = qMax(m_max.x, pt.x);
+		m_max.y = qMax(m_max.y, pt.y);
+		m_poly.append(pt);
+	}
+	if((m_poly.first().x != m_poly.last().x) || (m_poly.first().y != m_poly.last().y))
+		m_poly.append(m_poly.first());
+	m_valid = true;
+	return true;
+}
+
+//	name
+//	1
+//	   lon lat
+//	   ...
+//	END
+//	!2		(hole)
+//	...
+//	END
+bool TrOsmClip::readPoly(const QString & filename)
+{
+	clear();
+	QFile file(filename);
+	if(!file.open(QFile::ReadOnly | QFile::Text))
+	{
+		TR_WRN << "clip polygon" << filename << file.errorString();
+		return false;
+	}
+
+	QTextStream in(&file);
+	QVector<TrPoint> poly;
+	// 0: name, 1: section start, 2: points
+	int state = 0;
+	while(!in.atEnd())
+	{
+		QString line = in.readLine().trimmed();
+		if(line.isEmpty())
+			continue;
+		if(state == 0)
+		{
+			state = 1;
+		}
+		else if(state == 1)
+		{
+			if((line == "END") || line.startsWith('!'))
+			{
+				TR_WRN << "clip polygon" << filename << "without a ring";
+				return false;
+			}
+			state = 2;
+		}
+		else if(line == "END")
+		{
+			break;
+		}
+		else
+		{
+			QStringList val = line.simplified().split(' ');
+			bool ok_x = false;
+			bool ok_y = false;
+			TrPoint pt;
+			if(val.size() >= 2)
+			{
+				pt.x = val[0].toDouble(&ok_x) * TR_COOR_FACTOR;
+				pt.y = val[1].toDouble(&ok_y) * TR_COOR_FACTOR;
+			}
+			if(!(ok_x && ok_y))
+			{
+				TR_WRN << "clip polygon" << filename << "line" << line;
+				return false;
+			}
+			poly.append(pt);
+		}
+	}
+	return setPolygon(poly);
+}
+
+// crossing number, the products need 64 bit
+bool TrOsmClip::containsPoly(int32_t x, int32_t y) const
+{
+	bool inside = false;
+	const TrPoint32 * pts = m_poly.constData();
+
+	for(int i = 1; i < m_poly.size(); i++)
+	{
+		const TrPoint32 & p1 = pts[i-1];
+		const TrPoint32 & p2 = pts[i];
+		if((p1.y > y) == (p2.y > y))
+			continue;
+		int64_t dx = static_cast<int64_t>(p2.x) - p1.x;
+		int64_t dy = static_cast<int64_t>(p2.y) - p1.y;
+		int64_t cross = dx * (static_cast<int64_t>(y) - p1.y) - (static_cast<int64_t>(x) - p1.x) * dy;
+		// x of the edge at y is right of the point
+		if((dy > 0) ? (cross > 0) : (cross < 0))
+			inside = !inside;
+	}
+	return inside;
+}
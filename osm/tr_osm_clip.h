@@ -0,0 +1,89 @@
+/******************************************************************
+ *
+ * @short	clip region of the OSM import
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmClip
+ * superclass:	---
+ * modul:	tr_osm_clip.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+
+#ifndef TR_OSM_CLIP_H
+#define TR_OSM_CLIP_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+#include "tr_point.h"
+
+// Region for TrImportOsm::read, only the elements inside are imported.
+// The setters take map coordinates (TrPoint), 'contains' works on the
+// fixed point coordinates of Point_t.
+class TrOsmClip
+{
+private:
+	bool m_valid;
+	// surrounding rectangle, also of the polygon
+	TrPoint32 m_min;
+	TrPoint32 m_max;
+	// closed ring, empty for a rectangle
+	QVector<TrPoint32> m_poly;
+
+	static int32_t toFix(double val);
+	bool containsPoly(int32_t x, int32_t y) const;
+
+public:
+	TrOsmClip();
+	virtual ~TrOsmClip();
+
+	void setRect(const TrPoint & min, const TrPoint & max);
+	// at least 3 points, the ring is closed here
+	bool setPolygon(const QVector<TrPoint> & poly);
+	// first ring of an Osmosis .poly file (lon lat in degree), holes are ignored
+	bool readPoly(const QString & filename);
+	void clear();
+
+	bool isValid() const;
+	inline bool contains(int32_t x, int32_t y) const;
+};
+
+bool TrOsmClip::contains(int32_t x, int32_t y) const
+{
+	if((x < m_min.x) || (x > m_max.x) || (y < m_min.y) || (y > m_max.y))
+		return false;
+	if(m_poly.isEmpty())
+		return true;
+	return containsPoly(x, y);
+}
+
+#endif // TR_OSM_CLIP_H
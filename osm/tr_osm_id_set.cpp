@@ -0,0 +1,99 @@
+/******************************************************************
+ *
+ * @short	set of OSM ids as paged bitset
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmIdSet
+ * superclass:	---
+ * modul:	tr_osm_id_set.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_id_set.h"
+
+#include "tr_defs.h"
+
+#include <stdlib.h>
+
+TrOsmIdSet::TrOsmIdSet()
+	: m_count(0)
+{
+}
+
+TrOsmIdSet::~TrOsmIdSet()
+{
+	clear();
+}
+
+void TrOsmIdSet::clear()
+{
+	for(int i = 0; i < m_pages.size(); i++)
+		free(m_pages[i]);
+	m_pages.clear();
+	m_count = 0;
+}
+
+void TrOsmIdSet::set(uint64_t id)
+{
+	uint64_t page = id >> OSM_ID_PAGE_BITS;
+	if(page >= static_cast<uint64_t>(m_pages.size()))
+		m_pages.resize(static_cast<int>(page + 1));
+	if(m_pages[page] == nullptr)
+	{
+		m_pages[page] = static_cast<uint64_t *>(calloc(OSM_ID_PAGE_SIZE / 64, sizeof(uint64_t)));
+		if(m_pages[page] == nullptr)
+		{
+			TR_ERR << "no memory for id page" << page;
+			return;
+		}
+	}
+	uint64_t bit = id & (OSM_ID_PAGE_SIZE - 1);
+	uint64_t mask = static_cast<uint64_t>(1) << (bit & 63);
+	if(!(m_pages[page][bit >> 6] & mask))
+	{
+		m_pages[page][bit >> 6] |= mask;
+		m_count++;
+	}
+}
+
+uint64_t TrOsmIdSet::count() const
+{
+	return m_count;
+}
+
+size_t TrOsmIdSet::memorySize() const
+{
+	size_t size = m_pages.size() * sizeof(uint64_t *);
+	for(int i = 0; i < m_pages.size(); i++)
+	{
+		if(m_pages[i] != nullptr)
+			size += OSM_ID_PAGE_SIZE / 8;
+	}
+	return size;
+}
@@ -0,0 +1,79 @@
+/******************************************************************
+ *
+ * @short	set of OSM ids as paged bitset
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmIdSet
+ * superclass:	---
+ * modul:	tr_osm_id_set.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_ID_SET_H
+#define TR_OSM_ID_SET_H
+
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+// 2^21 ids (256 KB) per page
+#define OSM_ID_PAGE_BITS   21
+#define OSM_ID_PAGE_SIZE   (static_cast<uint64_t>(1) << OSM_ID_PAGE_BITS)
+
+// One bit per id, the pages are allocated on the first use,
+// so an extract with a small id range needs only a few pages.
+class TrOsmIdSet
+{
+private:
+	QVector<uint64_t *> m_pages;
+	uint64_t m_count;
+
+public:
+	TrOsmIdSet();
+	virtual ~TrOsmIdSet();
+
+	void set(uint64_t id);
+	inline bool contains(uint64_t id) const;
+	void clear();
+
+	// number of set ids
+	uint64_t count() const;
+	size_t memorySize() const;
+};
+
+bool TrOsmIdSet::contains(uint64_t id) const
+{
+	uint64_t page = id >> OSM_ID_PAGE_BITS;
+	if((page >= static_cast<uint64_t>(m_pages.size())) || (m_pages[page] == nullptr))
+		return false;
+	uint64_t bit = id & (OSM_ID_PAGE_SIZE - 1);
+	return (m_pages[page][bit >> 6] >> (bit & 63)) & 1;
+}
+
+#endif // TR_OSM_ID_SET_H
@@ -0,0 +1,421 @@
+/******************************************************************
+ *
+ * @short	decompression of .osm.gz and .osm.bz2 files
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmInflate
+ * superclass:	QIODevice
+ * modul:	tr_osm_inflate.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_inflate.h"
+
+#include "tr_defs.h"
+
+#include <bzlib.h>
+#include <zlib.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+TrOsmInflate::TrOsmInflate(const QString & filename)
+	: QIODevice()
+	, m_file(filename)
+	, m_format(format(filename))
+	, m_read_slot(0)
+	, m_write_slot(0)
+	, m_n_filled(0)
+	, m_read_pos(0)
+	, m_done(false)
+	, m_abort(false)
+{
+	m_reader.m_owner = this;
+	for(int i = 0; i < OSM_INFLATE_RING; i++)
+	{
+		m_buf[i] = nullptr;
+		m_buf_size[i] = 0;
+	}
+}
+
+TrOsmInflate::~TrOsmInflate()
+{
+	close();
+}
+
+TrOsmInflate::Format TrOsmInflate::format(const QString & filename)
+{
+	if(filename.endsWith(".gz", Qt::CaseInsensitive))
+		return GzipFormat;
+	if(filename.endsWith(".bz2", Qt::CaseInsensitive))
+		return Bzip2Format;
+	return NoFormat;
+}
+
+bool TrOsmInflate::isCompressed(const QString & filename)
+{
+	return (format(filename) != NoFormat);
+}
+
+bool TrOsmInflate::open(OpenMode mode)
+{
+	if((mode & QIODevice::WriteOnly) || (m_format == NoFormat) || isOpen())
+		return false;
+	if(!m_file.open(QFile::ReadOnly))
+	{
+		setErrorString(m_file.errorString());
+		return false;
+	}
+	char magic[3];
+	bool ok = (m_file.peek(magic, 3) == 3);
+	if(ok && (m_format == GzipFormat))
+		ok = ((static_cast<uchar>(magic[0]) == 0x1f) && (static_cast<uchar>(magic[1]) == 0x8b));
+	if(ok && (m_format == Bzip2Format))
+		ok = (memcmp(magic, "BZh", 3) == 0);
+	if(!ok)
+	{
+		TR_ERR << "not compressed:" << m_file.fileName();
+		setErrorString("unknown compression");
+		m_file.close();
+		return false;
+	}
+	for(int i = 0; i < OSM_INFLATE_RING; i++)
+	{
+		m_buf[i] = static_cast<char *>(malloc(OSM_INFLATE_BUFFER_SIZE));
+		if(m_buf[i] == nullptr)
+		{
+			TR_ERR << "no memory for inflate buffer";
+			close();
+			return false;
+		}
+	}
+	m_read_slot = 0;
+	m_write_slot = 0;
+	m_n_filled = 0;
+	m_read_pos = 0;
+	m_done = false;
+	m_abort = false;
+	m_error.clear();
+
+	// read() is copying from the ring, no buffer of QIODevice
+	QIODevice::open(mode | QIODevice::Unbuffered);
+	m_reader.start();
+	return true;
+}
+
+void TrOsmInflate::close()
+{
+	stopReader();
+	for(int i = 0; i < OSM_INFLATE_RING; i++)
+	{
+		free(m_buf[i]);
+		m_buf[i] = nullptr;
+	}
+	if(m_file.isOpen())
+		m_file.close();
+	if(isOpen())
+		QIODevice::close();
+}
+
+void TrOsmInflate::stopReader()
+{
+	if(!m_reader.isRunning())
+		return;
+	m_mutex.lock();
+	m_abort = true;
+	m_free.wakeAll();
+	m_mutex.unlock();
+	m_reader.wait();
+}
+
+bool TrOsmInflate::isSequential() const
+{
+	return true;
+}
+
+bool TrOsmInflate::atEnd() const
+{
+	QMutexLocker lock(&m_mutex);
+	return (m_done && (m_n_filled == 0));
+}
+
+qint64 TrOsmInflate::bytesAvailable() const
+{
+	QMutexLocker lock(&m_mutex);
+	qint64 size = 0;
+	for(int i = 0; i < m_n_filled; i++)
+		size += m_buf_size[(m_read_slot + i) % OSM_INFLATE_RING];
+	if(m_n_filled > 0)
+		size -= m_read_pos;
+	return size + QIODevice::bytesAvailable();
+}
+
+QString TrOsmInflate::inflateError() const
+{
+	QMutexLocker lock(&m_mutex);
+	return m_error;
+}
+
+qint64 TrOsmInflate::readData(char * data, qint64 maxlen)
+{
+	qint64 done = 0;
+	// waits only if nothing is copied
+	while((done < maxlen) && waitData(done == 0))
+	{
+		size_t size = qMin(static_cast<size_t>(maxlen - done), m_buf_size[m_read_slot] - m_read_pos);
+		memcpy(data + done, m_buf[m_read_slot] + m_read_pos, size);
+		m_read_pos += size;
+		done += size;
+		if(m_read_pos == m_buf_size[m_read_slot])
+			releaseSlot();
+	}
+	if(done == 0)
+	{
+		QString error = inflateError();
+		if(!error.isEmpty())
+		{
+			setErrorString(error);
+			return -1;
+		}
+	}
+	return done;
+}
+
+qint64 TrOsmInflate::writeData(const char * data, qint64 len)
+{
+	return -1;
+}
+
+bool TrOsmInflate::waitData(bool block)
+{
+	QMutexLocker lock(&m_mutex);
+	while(block && (m_n_filled == 0) && (!m_done))
+		m_filled.wait(&m_mutex);
+	return (m_n_filled > 0);
+}
+
+void TrOsmInflate::releaseSlot()
+{
+	QMutexLocker lock(&m_mutex);
+	m_read_slot = (m_read_slot + 1) % OSM_INFLATE_RING;
+	m_n_filled--;
+	m_read_pos = 0;
+	m_free.wakeOne();
+}
+
+// reader thread
+
+void TrOsmInflate::readLoop()
+{
+	QString error;
+	bool ok = (m_format == GzipFormat) ? inflateGzip(error) : inflateBzip2(error);
+	if(!ok)
+		TR_ERR << m_file.fileName() << error;
+
+	QMutexLocker lock(&m_mutex);
+	m_error = error;
+	m_done = true;
+	m_filled.wakeAll();
+}
+
+// nullptr if the reading is stopped
+char * TrOsmInflate::nextSlot()
+{
+	QMutexLocker lock(&m_mutex);
+	while((m_n_filled == OSM_INFLATE_RING) && (!m_abort))
+		m_free.wait(&m_mutex);
+	if(m_abort)
+		return nullptr;
+	return m_buf[m_write_slot];
+}
+
+void TrOsmInflate::fillSlot(size_t size)
+{
+	if(size == 0)
+		return;
+	QMutexLocker lock(&m_mutex);
+	m_buf_size[m_write_slot] = size;
+	m_write_slot = (m_write_slot + 1) % OSM_INFLATE_RING;
+	m_n_filled++;
+	m_filled.wakeOne();
+}
+
+qint64 TrOsmInflate::readInput(QByteArray & input)
+{
+	input.resize(OSM_INFLATE_INPUT_SIZE);
+	return m_file.read(input.data(), input.size());
+}
+
+bool TrOsmInflate::inflateGzip(QString & error)
+{
+	QByteArray input;
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	// 15 + 32: gzip or zlib header
+	if(inflateInit2(&zs, 15 + 32) != Z_OK)
+	{
+		error = "inflate init failed";
+		return false;
+	}
+
+	// inside of a gzip member
+	bool in_stream = false;
+	bool ok = true;
+	bool end = false;
+	while(ok && (!end))
+	{
+		char * out = nextSlot();
+		if(out == nullptr)
+			break;
+		zs.next_out = reinterpret_cast<Bytef *>(out);
+		zs.avail_out = OSM_INFLATE_BUFFER_SIZE;
+		while(zs.avail_out > 0)
+		{
+			if(zs.avail_in == 0)
+			{
+				qint64 n = readInput(input);
+				if(n < 0)
+				{
+					error = m_file.errorString();
+					ok = false;
+					break;
+				}
+				if(n == 0)
+				{
+					if(in_stream)
+					{
+						error = "file truncated";
+						ok = false;
+					}
+					end = true;
+					break;
+				}
+				zs.next_in = reinterpret_cast<Bytef *>(input.data());
+				zs.avail_in = static_cast<uInt>(n);
+			}
+			in_stream = true;
+			int ret = inflate(&zs, Z_NO_FLUSH);
+			if(ret == Z_STREAM_END)
+			{
+				// pigz and others are writing more than one member
+				inflateReset(&zs);
+				in_stream = false;
+			}
+			else if((ret != Z_OK) && (ret != Z_BUF_ERROR))
+			{
+				error = QString("inflate error %1").arg(ret);
+				ok = false;
+				break;
+			}
+		}
+		fillSlot(OSM_INFLATE_BUFFER_SIZE - zs.avail_out);
+	}
+	inflateEnd(&zs);
+	return ok;
+}
+
+bool TrOsmInflate::inflateBzip2(QString & error)
+{
+	QByteArray input;
+	bz_stream bz;
+	memset(&bz, 0, sizeof(bz));
+	if(BZ2_bzDecompressInit(&bz, 0, 0) != BZ_OK)
+	{
+		error = "bzip2 init failed";
+		return false;
+	}
+
+	bool in_stream = false;
+	bool ok = true;
+	bool end = false;
+	while(ok && (!end))
+	{
+		char * out = nextSlot();
+		if(out == nullptr)
+			break;
+		bz.next_out = out;
+		bz.avail_out = OSM_INFLATE_BUFFER_SIZE;
+		while(bz.avail_out > 0)
+		{
+			if(bz.avail_in == 0)
+			{
+				qint64 n = readInput(input);
+				if(n < 0)
+				{
+					error = m_file.errorString();
+					ok = false;
+					break;
+				}
+				if(n == 0)
+				{
+					if(in_stream)
+					{
+						error = "file truncated";
+						ok = false;
+					}
+					end = true;
+					break;
+				}
+				bz.next_in = input.data();
+				bz.avail_in = static_cast<unsigned int>(n);
+			}
+			in_stream = true;
+			int ret = BZ2_bzDecompress(&bz);
+			if(ret == BZ_STREAM_END)
+			{
+				// pbzip2 and lbzip2 are writing more than one stream
+				bz_stream next;
+				memset(&next, 0, sizeof(next));
+				next.next_in = bz.next_in;
+				next.avail_in = bz.avail_in;
+				next.next_out = bz.next_out;
+				next.avail_out = bz.avail_out;
+				BZ2_bzDecompressEnd(&bz);
+				bz = next;
+				// the end below frees what a failed init left
+				if(BZ2_bzDecompressInit(&bz, 0, 0) != BZ_OK)
+				{
+					error = "bzip2 init failed";
+					ok = false;
+					break;
+				}
+				in_stream = false;
+			}
+			else if(ret != BZ_OK)
+			{
+				error = QString("bzip2 error %1").arg(ret);
+				ok = false;
+				break;
+			}
+		}
+		fillSlot(OSM_INFLATE_BUFFER_SIZE - bz.avail_out);
+	}
+	BZ2_bzDecompressEnd(&bz);
+	return ok;
+}
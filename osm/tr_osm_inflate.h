@@ -0,0 +1,131 @@
+/******************************************************************
+ *
+ * @short	decompression of .osm.gz and .osm.bz2 files
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmInflate
+ * superclass:	QIODevice
+ * modul:	tr_osm_inflate.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_INFLATE_H
+#define TR_OSM_INFLATE_H
+
+#include <QtCore/qfile.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <stddef.h>
+
+// number and size of the decompressed buffers
+#define OSM_INFLATE_RING         8
+#define OSM_INFLATE_BUFFER_SIZE  (4 * 1024 * 1024)
+// read size of the compressed file
+#define OSM_INFLATE_INPUT_SIZE   (1024 * 1024)
+
+// Sequential device for QXmlStreamReader or for the window of
+// TrOsmXmlScan. A reader thread decompresses into a ring of buffers,
+// read() takes the filled buffers, so the decompression is running
+// while the XML is parsed and nothing is written to the disk.
+class TrOsmInflate : public QIODevice
+{
+public:
+	enum Format
+	{
+		NoFormat = 0,
+		GzipFormat,
+		Bzip2Format
+	};
+
+private:
+	class Reader : public QThread
+	{
+	public:
+		TrOsmInflate * m_owner;
+		virtual void run() { m_owner->readLoop(); }
+	};
+
+	QFile m_file;
+	Format m_format;
+	Reader m_reader;
+
+	// the filled buffers are 'm_read_slot' up to 'm_n_filled'
+	char * m_buf[OSM_INFLATE_RING];
+	size_t m_buf_size[OSM_INFLATE_RING];
+	int m_read_slot;
+	int m_write_slot;
+	int m_n_filled;
+	// position inside of 'm_read_slot', only used by the reading thread
+	size_t m_read_pos;
+	bool m_done;
+	bool m_abort;
+	QString m_error;
+
+	mutable QMutex m_mutex;
+	QWaitCondition m_filled;
+	QWaitCondition m_free;
+
+	// reader thread
+	void readLoop();
+	bool inflateGzip(QString & error);
+	bool inflateBzip2(QString & error);
+	char * nextSlot();
+	void fillSlot(size_t size);
+	qint64 readInput(QByteArray & input);
+
+	bool waitData(bool block);
+	void releaseSlot();
+	void stopReader();
+
+protected:
+	virtual qint64 readData(char * data, qint64 maxlen);
+	virtual qint64 writeData(const char * data, qint64 len);
+
+public:
+	TrOsmInflate(const QString & filename);
+	virtual ~TrOsmInflate();
+
+	// by the file name: ".gz" or ".bz2"
+	static Format format(const QString & filename);
+	static bool isCompressed(const QString & filename);
+
+	virtual bool open(OpenMode mode);
+	virtual void close();
+	virtual bool isSequential() const;
+	virtual bool atEnd() const;
+	virtual qint64 bytesAvailable() const;
+
+	// reading or decompression error, empty at a complete file
+	QString inflateError() const;
+};
+
+#endif // TR_OSM_INFLATE_H
@@ -35,96 +35,45 @@
 
 #include "osm_load.h"
 
-TrOsmLink::TrOsmLink()
-	: m_osm_lanes(0x00000000)
-	, m_osm_parking(0x00000000)
-	, m_osm_sidewalk(0x00000000)
-	, m_osm_width(0x00000000)
+uint32_t TrOsmLink::getOsmLanesFwd(const OsmRawWay_t & raw)
 {
-}
-
-TrOsmLink::~TrOsmLink()
-{
-}
-
-bool TrOsmLink::init(const TrZoomMap & zoom_ref, uint64_t ctrl, TrGeoObject * base)
-{
-	return false;
-}
-
-void TrOsmLink::setOsmLanes(uint32_t lanes)
-{
-	m_osm_lanes = lanes;
-}
-
-uint32_t TrOsmLink::getOsmWidth()
-{
-	return m_osm_width;
-}
-
-void TrOsmLink::setOsmWidth(uint32_t width)
-{
-	m_osm_width = width;
-}
-
-uint32_t TrOsmLink::getOsmLanesFwd()
-{
-	if(m_osm_lanes & FLAG_LANES_F)
+	if(raw.osm_lanes & FLAG_LANES_F)
 	{
-		return 0x0000000f & (m_osm_lanes >> 16);
+		return 0x0000000f & (raw.osm_lanes >> 16);
 	}
 	return 0;
 }
 
-uint32_t TrOsmLink::getOsmLanesBwd()
+uint32_t TrOsmLink::getOsmLanesBwd(const OsmRawWay_t & raw)
 {
-	if(m_osm_lanes & FLAG_LANES_B)
+	if(raw.osm_lanes & FLAG_LANES_B)
 	{
-		return 0x0000000f & (m_osm_lanes >> 24);
+		return 0x0000000f & (raw.osm_lanes >> 24);
 	}
 	return 0;
 }
 
-void TrOsmLink::setOsmParking(uint32_t park)
-{
-	m_osm_parking = park;
-
-	//TR_MSG << "F" << HEX << getOsmParkingFwd();
-	//TR_MSG << "B" << HEX << getOsmParkingBwd();
-}
-
-uint32_t TrOsmLink::getOsmParkingBwd() //Fwd()
+uint32_t TrOsmLink::getOsmParkingBwd(const OsmRawWay_t & raw) //Fwd()
 {
-	//if(m_osm_parking)
-	//	TR_INF <<  "FF" << HEX << (m_osm_parking >> 12);
-	return m_osm_parking >> 12;
+	//if(raw.parking)
+	//	TR_INF <<  "FF" << HEX << (raw.parking >> 12);
+	return raw.parking >> 12;
 }
 
 // change left and rigth for backward mode
-uint32_t TrOsmLink::getOsmParkingFwd() //Bwd()
+uint32_t TrOsmLink::getOsmParkingFwd(const OsmRawWay_t & raw) //Bwd()
 {
-    uint16_t p = static_cast<uint16_t>(m_osm_parking >> 12);
+    uint16_t p = static_cast<uint16_t>(raw.parking >> 12);
 
     uint16_t change = static_cast<uint16_t>(((p & 0x000000ff) << 8));
 	change |= ((p & 0x0000ff00) >> 8);
 
-	//if(m_osm_parking)
+	//if(raw.parking)
 	//	TR_INF <<  "BB" << HEX << change;
 	return change;
 }
 
-uint32_t TrOsmLink::getOsmSidewalk()
-{
-	return m_osm_sidewalk;
-}
-
-void TrOsmLink::setOsmSidewalk(uint32_t side)
-{
-	m_osm_sidewalk = side;
-}
-
-//void TrOsmLink::cloneLink(TrMapLink * orig, bool fwd, bool sideway)
-TrMapLink * TrOsmLink::cloneLink(bool fwd, bool sideway, bool is_road)
+TrMapLink * TrOsmLink::cloneLink(const OsmRawWay_t & raw, bool fwd, bool sideway, bool is_road)
 {
 
 	TrMapLinkRoad * orig_rd = nullptr;
@@ -140,11 +89,11 @@ TrMapLink * TrOsmLink::cloneLink(bool fwd, bool sideway, bool is_road)
 	if(orig == nullptr)
 		return nullptr;
 
-	if(sideway && getOneWay())
+	if(sideway && raw.oneway)
 	{
 		// OneWay and sidewalk -> create a footway for the routing
 		// TODO: check...
-		//if(!m_osm_sidewalk)
+		//if(!raw.sidewalk)
 		//	return orig;
 		//orig->setOneWay(1);
 		if(orig_rd != nullptr)
@@ -152,81 +101,81 @@ TrMapLink * TrOsmLink::cloneLink(bool fwd, bool sideway, bool is_road)
 		orig->setRdClass(15);
 		return orig;
 	}
-	orig->setOneWay(getOneWay());
-	//orig->setLanes(getLanes());
-	orig->setRdClass(getRdClass());
-	orig->setNameId(getNameId());
-	orig->setWidth(getOsmWidth());
+	orig->setOneWay(raw.oneway);
+	//orig->setLanes(raw.lanes);
+	orig->setRdClass(raw.rd_class);
+	orig->setNameId(raw.name_id);
+	orig->setWidth(static_cast<int32_t>(raw.width));
 
 	if(orig_rd != nullptr)
 	{
-		orig_rd->setLanes(getLanes());
+		orig_rd->setLanes(raw.lanes);
 		if(!fwd)
-            orig_rd->setParking(static_cast<uint16_t>(getOsmParkingFwd()));
+            orig_rd->setParking(static_cast<uint16_t>(getOsmParkingFwd(raw)));
 		else
-            orig_rd->setParking(static_cast<uint16_t>(getOsmParkingBwd()));
-		if(getLanes() == 0)
+            orig_rd->setParking(static_cast<uint16_t>(getOsmParkingBwd(raw)));
+		if(raw.lanes == 0)
 			orig_rd->setLanes(1);
 	}
 
-	if((!getOneWay()) && (orig_rd != nullptr))
+	if((!raw.oneway) && (orig_rd != nullptr))
 	{
-		if((m_osm_lanes & (FLAG_LANES_F | FLAG_LANES_B)) == 0)
+		if((raw.osm_lanes & (FLAG_LANES_F | FLAG_LANES_B)) == 0)
 		{
-			if(getLanes() > 1)
+			if(raw.lanes > 1)
 			{
-				orig_rd->setLanes(getLanes() >> 1);
-				//TR_MSG << "DOUBLE" << getLanes() << (getLanes() >> 1) << (osm_lanes & 0x000000000000000f);
+				orig_rd->setLanes(raw.lanes >> 1);
+				//TR_MSG << "DOUBLE" << raw.lanes << (raw.lanes >> 1) << (osm_lanes & 0x000000000000000f);
 			}
 		}
 		else
 		{
-			if((m_osm_lanes & FLAG_LANES_F) && (!(m_osm_lanes & FLAG_LANES_B)))
+			if((raw.osm_lanes & FLAG_LANES_F) && (!(raw.osm_lanes & FLAG_LANES_B)))
 			{
-				int lane = getLanes() - getOsmLanesFwd();
-				//TR_MSG << "F" << getLanes() << "|" << getOsmLanesFwd() << getOsmLanesBwd() << lane;
+				int lane = raw.lanes - getOsmLanesFwd(raw);
+				//TR_MSG << "F" << raw.lanes << "|" << getOsmLanesFwd(raw) << getOsmLanesBwd(raw) << lane;
 				if(fwd)
 				{
-					orig_rd->setLanes(getOsmLanesFwd());
+					orig_rd->setLanes(getOsmLanesFwd(raw));
 				}
 				else
 				{
 					if(lane > 0)
                         orig_rd->setLanes(static_cast<uint32_t>(lane));
 					else
-						orig_rd->setLanes(getLanes());
+						orig_rd->setLanes(raw.lanes);
 				}	
 			}
-			if((m_osm_lanes & FLAG_LANES_B) && (!(m_osm_lanes & FLAG_LANES_F)))
+			if((raw.osm_lanes & FLAG_LANES_B) && (!(raw.osm_lanes & FLAG_LANES_F)))
 			{
-				int lane = getLanes() - getOsmLanesBwd();
-				//TR_MSG << "B" << getLanes() << "|" << getOsmLanesFwd() << getOsmLanesBwd() << lane;
+				int lane = raw.lanes - getOsmLanesBwd(raw);
+				//TR_MSG << "B" << raw.lanes << "|" << getOsmLanesFwd(raw) << getOsmLanesBwd(raw) << lane;
 				if(fwd)
 				{
 					if(lane > 0)
                         orig_rd->setLanes(static_cast<uint32_t>(lane));
 					else
-						orig_rd->setLanes(getLanes());
+						orig_rd->setLanes(raw.lanes);
 				}
 				else
 				{
-					orig_rd->setLanes(getOsmLanesBwd());
+					orig_rd->setLanes(getOsmLanesBwd(raw));
 				}
 			}
-			if((m_osm_lanes & FLAG_LANES_F) && (m_osm_lanes & FLAG_LANES_B))
+			if((raw.osm_lanes & FLAG_LANES_F) && (raw.osm_lanes & FLAG_LANES_B))
 			{
 				if(fwd)
 				{
-					if(getOsmLanesFwd())
+					if(getOsmLanesFwd(raw))
 					{
-						orig_rd->setLanes(getOsmLanesFwd());
+						orig_rd->setLanes(getOsmLanesFwd(raw));
 					}
 				}
 				else
 				{
-					if(getOsmLanesBwd())
+					if(getOsmLanesBwd(raw))
 					{
-						orig_rd->setLanes(getOsmLanesBwd());
+						orig_rd->setLanes(getOsmLanesBwd(raw));
 					}
 				}
 			}
@@ -234,19 +183,3 @@ TrMapLink * TrOsmLink::cloneLink(bool fwd, bool sideway, bool is_road)
     }
     return orig;
 }
-
-QVector <uint64_t> * TrOsmLink::getRawNodes()
-{
-	return &m_raw_nodes;
-}
-
-void TrOsmLink::addRawNode(uint64_t next_node)
-{
-	m_raw_nodes.append(next_node);
-}
-
-void TrOsmLink::clearRawNodes()
-{
-	m_raw_nodes.clear();
-}
-
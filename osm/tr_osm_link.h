@@ -37,60 +37,47 @@
 #ifndef TR_OSM_LINK_H
 #define TR_OSM_LINK_H
 
-#include <QVector>
 #include <stdint.h>
 #include <tr_map_link.h>
 
 #include "tr_map_link_road.h"
 
-class TrOsmLink : public TrMapLinkRoad
+// raw way of the import, the node ids are in the node refs of the
+// ways (World_t::nd_refs), 'nd_ofs' is the position of the first id
+typedef struct
+{
+	uint64_t nd_ofs;
+	// node slots of the way in TrImportOsm::m_raw_slots
+	uint64_t slot_ofs;
+	uint32_t n_nd;
+	uint32_t name_id;
+	// lanes 7, lanesF << 16 lanesB << 24 and FLAG_LANES_F/B
+	uint32_t osm_lanes;
+	uint32_t parking;
+	// width in [mm]
+	uint32_t width;
+	uint16_t rd_class;
+	uint8_t lanes;
+	uint8_t oneway : 4;
+	uint8_t sidewalk : 1;
+}OsmRawWay_t;
+
+// 40 bytes, one for each way of the nets
+static_assert(sizeof(OsmRawWay_t) == 40, "OsmRawWay_t: size of the raw way record");
+
+// the attributes of a raw way, only the split links are created as objects
+class TrOsmLink
 {
-private:
-	uint32_t m_osm_lanes;
-	uint32_t m_osm_parking;
-	uint32_t m_osm_sidewalk;
-
-	uint32_t m_osm_width;
-
-	QVector <uint64_t> m_raw_nodes;
-
-protected:
-
 public:
-	TrOsmLink();
-
-	virtual ~TrOsmLink();
-
-	virtual bool init(const TrZoomMap & zoom_ref, uint64_t ctrl = 0, TrGeoObject * base = nullptr);
-
-	void setOsmLanes(uint32_t lanes);
-
-	uint32_t getOsmWidth();
+	static uint32_t getOsmLanesFwd(const OsmRawWay_t & raw);
 
-	void setOsmWidth(uint32_t width);
+	static uint32_t getOsmLanesBwd(const OsmRawWay_t & raw);
 
-	uint32_t getOsmLanesFwd();
+	static uint32_t getOsmParkingFwd(const OsmRawWay_t & raw);
 
-	uint32_t getOsmLanesBwd();
+	static uint32_t getOsmParkingBwd(const OsmRawWay_t & raw);
 
-	void setOsmParking(uint32_t park);
-
-	uint32_t getOsmParkingFwd();
-
-	uint32_t getOsmParkingBwd();
-
-	uint32_t getOsmSidewalk();
-
-	void setOsmSidewalk(uint32_t side);
-
-	TrMapLink * cloneLink(bool fwd, bool sideway, bool is_road);
-
-	QVector <uint64_t> * getRawNodes();
-
-	void addRawNode(uint64_t raw_node);
-
-	void clearRawNodes();
+	static TrMapLink * cloneLink(const OsmRawWay_t & raw, bool fwd, bool sideway, bool is_road);
 };
 
 #endif // TR_OSM_LINK_H
-
@@ -0,0 +1,164 @@
+/******************************************************************
+ *
+ * @short	dictionary of the names of the import
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmNameDict
+ * superclass:	---
+ * modul:	tr_osm_name_dict.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_name_dict.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qpair.h>
+
+#include <algorithm>
+
+TrOsmNameDict::TrOsmNameDict()
+{
+	clear();
+}
+
+TrOsmNameDict::~TrOsmNameDict()
+{
+}
+
+void TrOsmNameDict::clear()
+{
+	for(int s = 0; s < OSM_NAME_SHARDS; s++)
+	{
+		QMutexLocker lock(&m_shards[s].mutex);
+		m_shards[s].index.clear();
+		m_shards[s].names.clear();
+		m_shards[s].numbers.clear();
+		m_shards[s].final_ids.clear();
+	}
+	m_names.clear();
+	m_numbers.clear();
+	m_names.append(QString());
+	m_numbers.append(0);
+}
+
+uint64_t TrOsmNameDict::add(const QString & name)
+{
+	uint32_t s = qHash(name) & (OSM_NAME_SHARDS - 1);
+	Shard & shard = m_shards[s];
+
+	QMutexLocker lock(&shard.mutex);
+	QHash<QString, uint32_t>::const_iterator i = shard.index.constFind(name);
+	uint32_t pos = 0;
+	if(i == shard.index.constEnd())
+	{
+		pos = static_cast<uint32_t>(shard.names.size());
+		shard.index.insert(name, pos);
+		shard.names.append(name);
+		shard.numbers.append(1);
+	}
+	else
+	{
+		pos = i.value();
+		shard.numbers[pos]++;
+	}
+	return ((static_cast<uint64_t>(pos) + 1) << OSM_NAME_SHARD_BITS) | s;
+}
+
+void TrOsmNameDict::finish()
+{
+	// shard and position of all names
+	QVector<QPair<uint32_t, uint32_t> > order;
+	for(int s = 0; s < OSM_NAME_SHARDS; s++)
+	{
+		Shard & shard = m_shards[s];
+		for(int i = 0; i < shard.names.size(); i++)
+			order.append(qMakePair(static_cast<uint32_t>(s), static_cast<uint32_t>(i)));
+		shard.final_ids.fill(0, shard.names.size());
+	}
+	std::sort(order.begin(), order.end(),
+			[this](const QPair<uint32_t, uint32_t> & a, const QPair<uint32_t, uint32_t> & b)
+			{ return m_shards[a.first].names[a.second] < m_shards[b.first].names[b.second]; });
+
+	m_names.resize(1);
+	m_numbers.resize(1);
+	m_names.reserve(order.size() + 1);
+	m_numbers.reserve(order.size() + 1);
+	for(int i = 0; i < order.size(); i++)
+	{
+		Shard & shard = m_shards[order[i].first];
+		shard.final_ids[order[i].second] = static_cast<uint64_t>(m_names.size());
+		m_names.append(shard.names[order[i].second]);
+		m_numbers.append(shard.numbers[order[i].second]);
+	}
+	// only the conversion of the temporary ids is needed
+	for(int s = 0; s < OSM_NAME_SHARDS; s++)
+	{
+		m_shards[s].index.clear();
+		m_shards[s].names.clear();
+		m_shards[s].numbers.clear();
+	}
+	TR_INF << "names:" << order.size();
+}
+
+uint64_t TrOsmNameDict::finalId(uint64_t id) const
+{
+	if(id == 0)
+		return 0;
+	const Shard & shard = m_shards[id & (OSM_NAME_SHARDS - 1)];
+	uint64_t pos = (id >> OSM_NAME_SHARD_BITS) - 1;
+	if(pos >= static_cast<uint64_t>(shard.final_ids.size()))
+		return 0;
+	return shard.final_ids[static_cast<int>(pos)];
+}
+
+void TrOsmNameDict::appendName(const QString & name, uint32_t number)
+{
+	m_names.append(name);
+	m_numbers.append(number);
+}
+
+int TrOsmNameDict::size() const
+{
+	return m_names.size() - 1;
+}
+
+const QString & TrOsmNameDict::name(uint64_t id) const
+{
+	if(id >= static_cast<uint64_t>(m_names.size()))
+		return m_names[0];
+	return m_names[static_cast<int>(id)];
+}
+
+uint32_t TrOsmNameDict::number(uint64_t id) const
+{
+	if(id >= static_cast<uint64_t>(m_numbers.size()))
+		return 0;
+	return m_numbers[static_cast<int>(id)];
+}
@@ -0,0 +1,94 @@
+/******************************************************************
+ *
+ * @short	dictionary of the names of the import
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmNameDict
+ * superclass:	---
+ * modul:	tr_osm_name_dict.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_NAME_DICT_H
+#define TR_OSM_NAME_DICT_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+// 16 shards, each one with its own lock
+#define OSM_NAME_SHARD_BITS  4
+#define OSM_NAME_SHARDS      (1 << OSM_NAME_SHARD_BITS)
+
+// add() is thread safe and gives a temporary id with one lookup,
+// the shard is in the low bits. finish() sorts the names and gives
+// the final ids 1..size(), so they don't depend on the order of the
+// threads; the temporary ids are converted by finalId().
+class TrOsmNameDict
+{
+private:
+	struct Shard
+	{
+		QMutex mutex;
+		// position in 'names'
+		QHash<QString, uint32_t> index;
+		QVector<QString> names;
+		QVector<uint32_t> numbers;
+		QVector<uint64_t> final_ids;
+	};
+
+	Shard m_shards[OSM_NAME_SHARDS];
+	// by final id, 0 is no name
+	QVector<QString> m_names;
+	QVector<uint32_t> m_numbers;
+
+public:
+	TrOsmNameDict();
+	virtual ~TrOsmNameDict();
+
+	// temporary id, the number of the name is counted
+	uint64_t add(const QString & name);
+	// end of add()
+	void finish();
+	uint64_t finalId(uint64_t id) const;
+	void clear();
+
+	// a name with the next final id, used by the cache
+	void appendName(const QString & name, uint32_t number);
+
+	// number of final names
+	int size() const;
+	const QString & name(uint64_t id) const;
+	uint32_t number(uint64_t id) const;
+};
+
+#endif // TR_OSM_NAME_DICT_H
@@ -0,0 +1,209 @@
+/******************************************************************
+ *
+ * @short	node id to node slot index
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmNodeIndex
+ * superclass:	---
+ * modul:	tr_osm_node_index.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_node_index.h"
+
+#include "tr_defs.h"
+
+#include <QtCore/qtemporaryfile.h>
+
+#include <stdlib.h>
+
+TrOsmNodeIndex::TrOsmNodeIndex()
+	: m_mode(Auto)
+	, m_min_id(0)
+	, m_max_id(0)
+	, m_n_node(0)
+	, m_dense(nullptr)
+	, m_file(nullptr)
+	, m_ids(nullptr)
+	, m_bucket(nullptr)
+	, m_shift(0)
+{
+}
+
+TrOsmNodeIndex::~TrOsmNodeIndex()
+{
+	clear();
+}
+
+void TrOsmNodeIndex::clear()
+{
+	if(m_file != nullptr)
+	{
+		// the file is removed by the destructor
+		delete m_file;
+		m_file = nullptr;
+	}
+	else
+	{
+		free(m_dense);
+	}
+	m_dense = nullptr;
+	free(m_ids);
+	m_ids = nullptr;
+	free(m_bucket);
+	m_bucket = nullptr;
+	m_n_node = 0;
+	m_min_id = 0;
+	m_max_id = 0;
+	m_shift = 0;
+	m_mode = Auto;
+}
+
+TrOsmNodeIndex::Mode TrOsmNodeIndex::mode() const
+{
+	return m_mode;
+}
+
+bool TrOsmNodeIndex::create(const uint64_t * ids, size_t n_node, Mode mode)
+{
+	clear();
+	if((ids == nullptr) || (n_node == 0))
+		return true;
+
+	for(size_t i = 1; i < n_node; i++)
+	{
+		if(ids[i] <= ids[i-1])
+		{
+			TR_ERR << "nodes not sorted:" << ids[i];
+			return false;
+		}
+	}
+	m_min_id = ids[0];
+	m_max_id = ids[n_node-1];
+
+	uint64_t range = m_max_id - m_min_id + 1;
+	if(mode == Auto)
+	{
+		if((range / OSM_INDEX_DENSE_FACTOR) <= n_node)
+			mode = Dense;
+		else
+			mode = Sorted;
+	}
+	// the dense table uses 32 bit slots
+	if((mode == Dense) && (n_node >= UINT32_MAX))
+		mode = Sorted;
+
+	bool ret = false;
+	if(mode == Dense)
+		ret = createDense(ids, n_node);
+	if(!ret)
+		ret = createSorted(ids, n_node);
+	if(ret)
+	{
+		m_n_node = n_node;
+		TR_INF << ((m_mode == Dense) ? "dense" : "sorted") << "node index, ids:" << range
+				<< "nodes:" << n_node;
+	}
+	return ret;
+}
+
+bool TrOsmNodeIndex::createDense(const uint64_t * ids, size_t n_node)
+{
+	uint64_t range = m_max_id - m_min_id + 1;
+	uint64_t size = range * sizeof(uint32_t);
+
+	if(size <= OSM_INDEX_MEM_LIMIT)
+	{
+		m_dense = static_cast<uint32_t *>(calloc(range, sizeof(uint32_t)));
+		if(m_dense == nullptr)
+			return false;
+	}
+	else
+	{
+		// the file is sparse, only the used pages are written
+		m_file = new QTemporaryFile();
+		if((!m_file->open()) || (!m_file->resize(static_cast<qint64>(size))))
+		{
+			TR_WRN << "no index file" << m_file->errorString();
+			delete m_file;
+			m_file = nullptr;
+			return false;
+		}
+		m_dense = reinterpret_cast<uint32_t *>(m_file->map(0, static_cast<qint64>(size)));
+		if(m_dense == nullptr)
+		{
+			TR_WRN << "index file not mapped" << m_file->errorString();
+			delete m_file;
+			m_file = nullptr;
+			return false;
+		}
+	}
+	for(size_t i = 0; i < n_node; i++)
+	{
+		m_dense[ids[i] - m_min_id] = static_cast<uint32_t>(i + 1);
+	}
+	m_mode = Dense;
+	return true;
+}
+
+bool TrOsmNodeIndex::createSorted(const uint64_t * ids, size_t n_node)
+{
+	uint64_t range = m_max_id - m_min_id;
+
+	m_ids = static_cast<uint64_t *>(malloc(sizeof(uint64_t) * n_node));
+	if(m_ids == nullptr)
+		return false;
+	for(size_t i = 0; i < n_node; i++)
+		m_ids[i] = ids[i];
+
+	m_shift = 0;
+	uint64_t n_target = (n_node / OSM_INDEX_BUCKET_NODES) + 1;
+	while((range >> m_shift) > n_target)
+		m_shift++;
+
+	// the last bucket is the end of the array
+	size_t n_bucket = static_cast<size_t>(range >> m_shift) + 2;
+	m_bucket = static_cast<size_t *>(malloc(sizeof(size_t) * n_bucket));
+	if(m_bucket == nullptr)
+	{
+		free(m_ids);
+		m_ids = nullptr;
+		return false;
+	}
+	size_t slot = 0;
+	for(size_t b = 0; b < n_bucket; b++)
+	{
+		uint64_t start = static_cast<uint64_t>(b) << m_shift;
+		while((slot < n_node) && ((m_ids[slot] - m_min_id) < start))
+			slot++;
+		m_bucket[b] = slot;
+	}
+	m_mode = Sorted;
+	return true;
+}
@@ -0,0 +1,127 @@
+/******************************************************************
+ *
+ * @short	node id to node slot index
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmNodeIndex
+ * superclass:	---
+ * modul:	tr_osm_node_index.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_NODE_INDEX_H
+#define TR_OSM_NODE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "osm_types.h"
+
+class QTemporaryFile;
+
+// dense tables up to this size are in memory, bigger ones in a
+// (sparse) temporary file
+#define OSM_INDEX_MEM_LIMIT      (256 * 1024 * 1024)
+// the dense table is used up to this number of ids per node
+#define OSM_INDEX_DENSE_FACTOR   16
+// mean number of nodes per bucket of the sorted index
+#define OSM_INDEX_BUCKET_NODES   8
+
+// Finds the slot of a node id in the (sorted) node array of World_t.
+// Dense: one slot entry for every id between the min and max id.
+// Sorted: compact copy of the ids, a bucket table on the upper id bits
+// gives a small range for the binary search.
+class TrOsmNodeIndex
+{
+public:
+	enum Mode
+	{
+		Auto = 0,
+		Sorted,
+		Dense
+	};
+
+private:
+	Mode m_mode;
+	uint64_t m_min_id;
+	uint64_t m_max_id;
+	size_t m_n_node;
+
+	// dense: slot + 1, 0 for an unknown id
+	uint32_t * m_dense;
+	QTemporaryFile * m_file;
+
+	// sorted
+	uint64_t * m_ids;
+	size_t * m_bucket;
+	int m_shift;
+
+	bool createDense(const uint64_t * ids, size_t n_node);
+	bool createSorted(const uint64_t * ids, size_t n_node);
+
+public:
+	TrOsmNodeIndex();
+	virtual ~TrOsmNodeIndex();
+
+	// 'ids' must be sorted
+	bool create(const uint64_t * ids, size_t n_node, Mode mode = Auto);
+	void clear();
+
+	Mode mode() const;
+
+	// slot in the node array, -1 for an unknown id
+	inline int64_t find(uint64_t id) const;
+};
+
+int64_t TrOsmNodeIndex::find(uint64_t id) const
+{
+	if((m_n_node == 0) || (id < m_min_id) || (id > m_max_id))
+		return -1;
+
+	uint64_t rel = id - m_min_id;
+	if(m_mode == Dense)
+		return static_cast<int64_t>(m_dense[rel]) - 1;
+
+	size_t b = static_cast<size_t>(rel >> m_shift);
+	size_t pos1 = m_bucket[b];
+	size_t pos2 = m_bucket[b + 1];
+	while(pos1 < pos2)
+	{
+		size_t mid = pos1 + ((pos2 - pos1) >> 1);
+		if(m_ids[mid] < id)
+			pos1 = mid + 1;
+		else
+			pos2 = mid;
+	}
+	if((pos1 < m_n_node) && (m_ids[pos1] == id))
+		return static_cast<int64_t>(pos1);
+	return -1;
+}
+
+#endif // TR_OSM_NODE_INDEX_H
@@ -0,0 +1,223 @@
+/******************************************************************
+ *
+ * @short	rings of the multipolygon relations
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmRing
+ * superclass:	---
+ * modul:	tr_osm_ring.cpp
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+#include "tr_osm_ring.h"
+
+#include "tr_defs.h"
+#include "tr_import_osm_rel.h"
+#include "osm_load_rel.h"
+
+#include <QtCore/qhash.h>
+
+TrOsmRing::TrOsmRing(Way_t * ways, size_t n_way, const uint64_t * nd_refs,
+		const TrOsmNodeIndex & node_index, const Coor_t * node_coor)
+	: m_ways(ways)
+	, m_n_way(n_way)
+	, m_nd_refs(nd_refs)
+	, m_node_index(node_index)
+	, m_node_coor(node_coor)
+{
+}
+
+TrOsmRing::~TrOsmRing()
+{
+}
+
+uint64_t TrOsmRing::firstNode(const Way_t & way) const
+{
+	return m_nd_refs[way.nd_ofs];
+}
+
+uint64_t TrOsmRing::lastNode(const Way_t & way) const
+{
+	return m_nd_refs[way.nd_ofs + way.n_nd_id - 1];
+}
+
+int TrOsmRing::assemble(const Rel_t & rel, uint16_t role, QVector<OsmRing> & rings) const
+{
+	QVector<const Way_t *> ways;
+	for(uint32_t i = 0; i < rel.r_count; i++)
+	{
+		if(!(rel.members[i].flags & role))
+			continue;
+		// a missing way is outside of the clip or not read
+		const Way_t * way = TrImportOsmRel::findWay(m_ways, m_n_way, rel.members[i].id);
+		if((way != nullptr) && (way->n_nd_id >= 2))
+			ways.append(way);
+	}
+
+	// both ends of the open ways
+	QMultiHash<uint64_t, int> ends;
+	QVector<char> used(ways.size(), 0);
+	OsmRingWay_t rway;
+	OsmRing ring;
+	int n_open = 0;
+
+	ends.reserve(2 * ways.size());
+	for(int i = 0; i < ways.size(); ++i)
+	{
+		uint64_t first = firstNode(*ways[i]);
+		uint64_t last = lastNode(*ways[i]);
+		if(first == last)
+		{
+			// closed way
+			rway.way = ways[i];
+			rway.reverse = false;
+			ring.clear();
+			ring.append(rway);
+			rings.append(ring);
+			used[i] = 1;
+			continue;
+		}
+		ends.insert(first, i);
+		ends.insert(last, i);
+	}
+
+	for(int i = 0; i < ways.size(); ++i)
+	{
+		if(used[i])
+			continue;
+
+		uint64_t start = firstNode(*ways[i]);
+		uint64_t end = lastNode(*ways[i]);
+		int n_way = 1;
+
+		used[i] = 1;
+		rway.way = ways[i];
+		rway.reverse = false;
+		ring.clear();
+		ring.append(rway);
+
+		while(end != start)
+		{
+			int next = -1;
+			QMultiHash<uint64_t, int>::const_iterator it = ends.constFind(end);
+			for(; (it != ends.constEnd()) && (it.key() == end); ++it)
+			{
+				if(!used[it.value()])
+				{
+					next = it.value();
+					break;
+				}
+			}
+			if(next < 0)
+				break;
+
+			used[next] = 1;
+			rway.way = ways[next];
+			rway.reverse = (firstNode(*ways[next]) != end);
+			end = rway.reverse ? firstNode(*ways[next]) : lastNode(*ways[next]);
+			ring.append(rway);
+			n_way++;
+		}
+
+		if(end == start)
+			rings.append(ring);
+		else
+			n_open += n_way;
+	}
+	return n_open;
+}
+
+bool TrOsmRing::appendPoints(const OsmRing & ring, TrMapFace & face) const
+{
+	TrPoint pt;
+
+	for(int i = 0; i < ring.size(); ++i)
+	{
+		const Way_t & way = *ring[i].way;
+		const uint64_t * nd_id = m_nd_refs + way.nd_ofs;
+
+		for(int j = 1; j < way.n_nd_id; j++)
+		{
+			int k = ring[i].reverse ? (way.n_nd_id - 1 - j) : j;
+			int64_t slot = m_node_index.find(nd_id[k]);
+			if(slot < 0)
+				return false;
+
+			pt.x = (m_node_coor[slot].x/100.0);
+			pt.y = (m_node_coor[slot].y/100.0);
+			face.appendPolyPoint(pt);
+		}
+	}
+	return true;
+}
+
+int TrOsmRing::createFaces(const Rel_t & rel, QVector<TrMapFace *> & faces) const
+{
+	QVector<OsmRing> rings;
+	int n_outer = 0;
+
+	int n_open = assemble(rel, REL_MEM_ROLE_OUT, rings);
+	n_outer = rings.size();
+	n_open += assemble(rel, REL_MEM_ROLE_IN, rings);
+	if(n_open)
+		TR_WRN << "relation" << rel.id << "ways without a ring:" << n_open;
+
+	for(int i = 0; i < rings.size(); ++i)
+	{
+		bool outer = (i < n_outer);
+		const Way_t & way = *rings[i][0].way;
+		// the way has the layer of the relation, see 'TrImportOsmRel::handleMultiPoly'
+		bool way_face = ((way.type & rel.flags & 0x0000000000f00000) != 0);
+		// a closed way of a layer is a face of the way list already
+		if((rings[i].size() == 1) && way_face)
+			continue;
+		// an inner ring without a class of its own
+		if((!outer) && (!way_face))
+			continue;
+
+		TrMapFace * face = new TrMapFace();
+		face->appendPolygon(0);
+		if(!appendPoints(rings[i], *face))
+		{
+			delete face;
+			continue;
+		}
+
+		face->setFaceClass(rel.flags >> 16);
+		if(outer)
+			face->setType(rel.flags | 0x4000);
+		else
+		{
+			// class of the inner way
+			uint64_t type = (way.type & 0x000000f000000000) >> 24;
+			face->setType((way.type & 0x000000000000000f) | type);
+		}
+		faces.append(face);
+	}
+	return faces.size();
+}
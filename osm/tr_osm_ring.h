@@ -0,0 +1,91 @@
+/******************************************************************
+ *
+ * @short	rings of the multipolygon relations
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmRing
+ * superclass:	---
+ * modul:	tr_osm_ring.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+
+#ifndef TR_OSM_RING_H
+#define TR_OSM_RING_H
+
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+#include "osm_types.h"
+#include "tr_osm_node_index.h"
+#include "tr_map_face.h"
+
+// a member way of a ring, 'reverse': from the last to the first node
+typedef struct
+{
+	const Way_t * way;
+	bool reverse;
+}OsmRingWay_t;
+
+typedef QVector<OsmRingWay_t> OsmRing;
+
+// Joins the member ways of a relation to closed rings. The ends of the
+// ways are in a hash, the order of the members doesn't matter.
+// All methods are const, one object is used by all threads.
+class TrOsmRing
+{
+private:
+	// sorted by id
+	Way_t * m_ways;
+	size_t m_n_way;
+	const uint64_t * m_nd_refs;
+	const TrOsmNodeIndex & m_node_index;
+	const Coor_t * m_node_coor;
+
+	uint64_t firstNode(const Way_t & way) const;
+	uint64_t lastNode(const Way_t & way) const;
+
+public:
+	TrOsmRing(Way_t * ways, size_t n_way, const uint64_t * nd_refs,
+			const TrOsmNodeIndex & node_index, const Coor_t * node_coor);
+	virtual ~TrOsmRing();
+
+	// closed rings of the members with 'role' (REL_MEM_ROLE_OUT, ...),
+	// returns the number of ways which are not part of a ring
+	int assemble(const Rel_t & rel, uint16_t role, QVector<OsmRing> & rings) const;
+	// the first node of each way is skipped, the ring is not closed twice
+	bool appendPoints(const OsmRing & ring, TrMapFace & face) const;
+
+	// one face for each outer ring and each inner ring of a layer, a single
+	// closed way with the layer of the relation is a face of the way list already
+	int createFaces(const Rel_t & rel, QVector<TrMapFace *> & faces) const;
+};
+
+#endif // TR_OSM_RING_H
@@ -0,0 +1,215 @@
+/******************************************************************
+ *
+ * @short	interned tag keys and values of the import
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmTagPool
+ * superclass:	---
+ * modul:	tr_osm_tag_pool.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_tag_pool.h"
+
+#include "tr_defs.h"
+
+#include <string.h>
+
+#define OSM_TAG_POOL_START  1024
+
+// same order as OsmTagKey
+static const char * s_tag_keys[OSM_KEY_COUNT] =
+{
+	"highway",
+	"railway",
+	"natural",
+	"amenity",
+	"shop",
+	"barrier",
+	"building",
+	"landuse",
+	"waterway",
+	"oneway",
+	"junction",
+	"power",
+	"name",
+	"name:en",
+	"width",
+	"lanes",
+	"lanes:forward",
+	"lanes:backward"
+};
+
+// FNV-1a like osmTagHash, false for a character outside of ASCII
+template <typename C>
+static bool osmPoolHash(const C * str, int len, uint32_t & hash)
+{
+	hash = 2166136261U;
+	for(int i = 0; i < len; i++)
+	{
+		uint32_t c = static_cast<uint32_t>(str[i]);
+		if(c > 0x7f)
+			return false;
+		hash = (hash ^ c) * 16777619U;
+	}
+	hash ^= (hash >> 15);
+	return true;
+}
+
+template <typename C>
+static bool osmPoolEqual(const QString & text, const C * str, int len)
+{
+	if(text.size() != len)
+		return false;
+	const ushort * c = text.utf16();
+	for(int i = 0; i < len; i++)
+	{
+		if(c[i] != static_cast<ushort>(str[i]))
+			return false;
+	}
+	return true;
+}
+
+TrOsmTagPool::TrOsmTagPool()
+	: m_mask(OSM_TAG_POOL_START - 1)
+{
+	m_slots.fill(0, OSM_TAG_POOL_START);
+	for(int i = 0; i < OSM_KEY_COUNT; i++)
+		internT(s_tag_keys[i], static_cast<int>(strlen(s_tag_keys[i])));
+}
+
+TrOsmTagPool::~TrOsmTagPool()
+{
+}
+
+bool TrOsmTagPool::isTextKey(uint32_t key)
+{
+	return ((key >= OSM_KEY_NAME) && (key < OSM_KEY_COUNT));
+}
+
+uint32_t TrOsmTagPool::fixedKey(const char * str, int len)
+{
+	if(len <= 0)
+		return OSM_TAG_NONE;
+	for(int i = 0; i < OSM_KEY_COUNT; i++)
+	{
+		if((s_tag_keys[i][0] == str[0]) && (strlen(s_tag_keys[i]) == static_cast<size_t>(len)) &&
+				(memcmp(s_tag_keys[i], str, len) == 0))
+			return static_cast<uint32_t>(i);
+	}
+	return OSM_TAG_NONE;
+}
+
+template <typename C>
+uint32_t TrOsmTagPool::findT(const C * str, int len, uint32_t & slot) const
+{
+	uint32_t hash = 0;
+	if(!osmPoolHash(str, len, hash))
+		return OSM_TAG_NONE;
+	slot = hash & m_mask;
+	while(m_slots[slot] != 0)
+	{
+		uint32_t id = m_slots[slot] - 1;
+		if(osmPoolEqual(m_strings[id], str, len))
+			return id;
+		slot = (slot + 1) & m_mask;
+	}
+	return OSM_TAG_NONE;
+}
+
+template <typename C>
+uint32_t TrOsmTagPool::internT(const C * str, int len)
+{
+	uint32_t slot = OSM_TAG_NONE;
+	uint32_t id = findT(str, len, slot);
+	if(id != OSM_TAG_NONE)
+		return id;
+	// not ASCII
+	if(slot == OSM_TAG_NONE)
+		return OSM_TAG_NONE;
+
+	QString text(len, Qt::Uninitialized);
+	QChar * c = text.data();
+	for(int i = 0; i < len; i++)
+		c[i] = QChar(static_cast<ushort>(str[i]));
+	id = static_cast<uint32_t>(m_strings.size());
+	m_strings.append(text);
+	m_slots[slot] = id + 1;
+	// half empty
+	if((static_cast<uint32_t>(m_strings.size()) * 2) > m_mask)
+		grow();
+	return id;
+}
+
+void TrOsmTagPool::grow()
+{
+	m_mask = (m_mask << 1) | 1;
+	m_slots.fill(0, static_cast<int>(m_mask + 1));
+	for(int i = 0; i < m_strings.size(); i++)
+	{
+		uint32_t hash = 0;
+		osmPoolHash(m_strings[i].utf16(), m_strings[i].size(), hash);
+		uint32_t slot = hash & m_mask;
+		while(m_slots[slot] != 0)
+			slot = (slot + 1) & m_mask;
+		m_slots[slot] = static_cast<uint32_t>(i) + 1;
+	}
+}
+
+uint32_t TrOsmTagPool::find(const char * str, int len) const
+{
+	uint32_t slot = 0;
+	return findT(str, len, slot);
+}
+
+uint32_t TrOsmTagPool::find(const ushort * str, int len) const
+{
+	uint32_t slot = 0;
+	return findT(str, len, slot);
+}
+
+uint32_t TrOsmTagPool::intern(const char * str, int len)
+{
+	return internT(str, len);
+}
+
+uint32_t TrOsmTagPool::intern(const ushort * str, int len)
+{
+	return internT(str, len);
+}
+
+const QString & TrOsmTagPool::string(uint32_t id) const
+{
+	return m_strings[static_cast<int>(id)];
+}
+
+int TrOsmTagPool::size() const
+{
+	return m_strings.size();
+}
@@ -0,0 +1,115 @@
+/******************************************************************
+ *
+ * @short	interned tag keys and values of the import
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmTagPool
+ * superclass:	---
+ * modul:	tr_osm_tag_pool.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_TAG_POOL_H
+#define TR_OSM_TAG_POOL_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <stdint.h>
+
+#define OSM_TAG_NONE        0xffffffffU
+// value is an index in the text list of the element, not a pool id
+#define OSM_TAG_TEXT        0x80000000U
+
+// keys used by TrImportOsmStream, the first ids of the pool
+enum OsmTagKey
+{
+	OSM_KEY_HIGHWAY = 0,
+	OSM_KEY_RAILWAY,
+	OSM_KEY_NATURAL,
+	OSM_KEY_AMENITY,
+	OSM_KEY_SHOP,
+	OSM_KEY_BARRIER,
+	OSM_KEY_BUILDING,
+	OSM_KEY_LANDUSE,
+	OSM_KEY_WATERWAY,
+	OSM_KEY_ONEWAY,
+	OSM_KEY_JUNCTION,
+	OSM_KEY_POWER,
+	// free text values, not in the pool
+	OSM_KEY_NAME,
+	OSM_KEY_NAME_EN,
+	OSM_KEY_WIDTH,
+	OSM_KEY_LANES,
+	OSM_KEY_LANES_FORWARD,
+	OSM_KEY_LANES_BACKWARD,
+	OSM_KEY_COUNT
+};
+
+typedef struct
+{
+	uint32_t key;
+	uint32_t value;
+}OsmTag_t;
+
+// Keys and the values of the classified keys are stored once for the
+// whole import, an element has only the ids. The pool is used by the
+// sink only, so there is no lock.
+class TrOsmTagPool
+{
+private:
+	QVector<QString> m_strings;
+	// id + 1, 0 for an empty slot
+	QVector<uint32_t> m_slots;
+	uint32_t m_mask;
+
+	template <typename C> uint32_t findT(const C * str, int len, uint32_t & slot) const;
+	template <typename C> uint32_t internT(const C * str, int len);
+	void grow();
+
+public:
+	TrOsmTagPool();
+	virtual ~TrOsmTagPool();
+
+	// OSM_TAG_NONE for an unknown string
+	uint32_t find(const char * str, int len) const;
+	uint32_t find(const ushort * str, int len) const;
+	// OSM_TAG_NONE for a text outside of ASCII
+	uint32_t intern(const char * str, int len);
+	uint32_t intern(const ushort * str, int len);
+
+	const QString & string(uint32_t id) const;
+	int size() const;
+
+	static bool isTextKey(uint32_t key);
+	// OsmTagKey of 'str', OSM_TAG_NONE for all other keys, no lock needed
+	static uint32_t fixedKey(const char * str, int len);
+};
+
+#endif // TR_OSM_TAG_POOL_H
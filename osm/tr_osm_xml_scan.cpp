@@ -0,0 +1,358 @@
+/******************************************************************
+ *
+ * @short	tokenizer for the OSM subset of XML
+ *
+ * project:	Trafalgar/Osm
+ *
+ * class:	TrOsmXmlScan
+ * superclass:	---
+ * modul:	tr_osm_xml_scan.cc
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#include "tr_osm_xml_scan.h"
+
+#include <QtCore/qbytearray.h>
+
+#include <string.h>
+
+static inline bool isXmlSpace(char c)
+{
+	return ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t'));
+}
+
+TrOsmXmlScan::TrOsmXmlScan()
+	: m_data(nullptr)
+	, m_size(0)
+	, m_pos(0)
+	, m_token_pos(0)
+	, m_type(NoToken)
+	, m_empty_elem(false)
+	, m_n_attr(0)
+{
+	m_name = osmView(nullptr, 0);
+}
+
+TrOsmXmlScan::~TrOsmXmlScan()
+{
+}
+
+void TrOsmXmlScan::setData(const char * data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+	m_pos = 0;
+	m_token_pos = 0;
+	m_type = NoToken;
+	m_empty_elem = false;
+	m_n_attr = 0;
+	m_error.clear();
+}
+
+bool TrOsmXmlScan::atEnd() const
+{
+	if(m_empty_elem)
+		return false;
+	if((m_type == NeedData) || (m_type == Invalid))
+		return true;
+	return (m_pos >= m_size);
+}
+
+bool TrOsmXmlScan::isStartElement() const
+{
+	return (m_type == StartElement);
+}
+
+bool TrOsmXmlScan::isEndElement() const
+{
+	return (m_type == EndElement);
+}
+
+bool TrOsmXmlScan::hasError() const
+{
+	return (m_type == Invalid);
+}
+
+const OsmView_t & TrOsmXmlScan::name() const
+{
+	return m_name;
+}
+
+size_t TrOsmXmlScan::tokenPosition() const
+{
+	return m_token_pos;
+}
+
+QString TrOsmXmlScan::errorString() const
+{
+	return m_error;
+}
+
+bool TrOsmXmlScan::attribute(const char * key, OsmView_t & value) const
+{
+	for(int i = 0; i < m_n_attr; i++)
+	{
+		if(osmViewIs(m_keys[i], key))
+		{
+			value = m_values[i];
+			return true;
+		}
+	}
+	value = osmView(nullptr, 0);
+	return false;
+}
+
+bool TrOsmXmlScan::skipTo(const char * pattern, size_t len)
+{
+	const char * end = m_data + m_size;
+	const char * act = m_data + m_pos;
+
+	while(act + len <= end)
+	{
+		const char * hit = static_cast<const char *>(memchr(act, pattern[0], end - act));
+		if((hit == nullptr) || (hit + len > end))
+			return false;
+		if(memcmp(hit, pattern, len) == 0)
+		{
+			m_pos = (hit + len) - m_data;
+			return true;
+		}
+		act = hit + 1;
+	}
+	return false;
+}
+
+TrOsmXmlScan::TokenType TrOsmXmlScan::readTag(const char * end)
+{
+	const char * act = m_data + m_pos;
+	bool is_end = false;
+
+	m_n_attr = 0;
+	if(*act == '/')
+	{
+		is_end = true;
+		act++;
+	}
+	const char * name = act;
+	while((act < end) && (!isXmlSpace(*act)) && (*act != '>') && (*act != '/'))
+		act++;
+	if(act >= end)
+		return NeedData;
+	m_name = osmView(name, static_cast<int32_t>(act - name));
+
+	while(true)
+	{
+		while((act < end) && isXmlSpace(*act))
+			act++;
+		if(act >= end)
+			return NeedData;
+		if(*act == '>')
+		{
+			m_pos = (act + 1) - m_data;
+			return (is_end ? EndElement : StartElement);
+		}
+		if(*act == '/')
+		{
+			if(act + 1 >= end)
+				return NeedData;
+			if(act[1] != '>')
+				break;
+			m_pos = (act + 2) - m_data;
+			m_empty_elem = true;
+			return StartElement;
+		}
+		// attribute: key="value" or key='value'
+		const char * key = act;
+		while((act < end) && (*act != '=') && (!isXmlSpace(*act)) && (*act != '>'))
+			act++;
+		const char * key_end = act;
+		while((act < end) && isXmlSpace(*act))
+			act++;
+		if(act >= end)
+			return NeedData;
+		if(*act != '=')
+			break;
+		act++;
+		while((act < end) && isXmlSpace(*act))
+			act++;
+		if(act >= end)
+			return NeedData;
+		char quote = *act;
+		if((quote != '"') && (quote != '\''))
+			break;
+		act++;
+		const char * value_end = static_cast<const char *>(memchr(act, quote, end - act));
+		if(value_end == nullptr)
+			return NeedData;
+		if(m_n_attr < OSM_SCAN_MAX_ATTR)
+		{
+			m_keys[m_n_attr] = osmView(key, static_cast<int32_t>(key_end - key));
+			m_values[m_n_attr] = osmView(act, static_cast<int32_t>(value_end - act));
+			m_n_attr++;
+		}
+		act = value_end + 1;
+	}
+	m_error = QString("syntax error at byte %1").arg(act - m_data);
+	return Invalid;
+}
+
+TrOsmXmlScan::TokenType TrOsmXmlScan::readNext()
+{
+	if(m_empty_elem)
+	{
+		// second part of <nd ref="1"/>
+		m_empty_elem = false;
+		m_n_attr = 0;
+		m_type = EndElement;
+		return m_type;
+	}
+	if((m_type == NeedData) || (m_type == Invalid))
+		return m_type;
+
+	const char * end = m_data + m_size;
+
+	while(m_pos < m_size)
+	{
+		const char * lt = static_cast<const char *>(memchr(m_data + m_pos, '<', m_size - m_pos));
+		if(lt == nullptr)
+		{
+			m_pos = m_size;
+			break;
+		}
+		m_token_pos = lt - m_data;
+		m_pos = m_token_pos + 1;
+		if(m_pos >= m_size)
+		{
+			m_type = NeedData;
+			return m_type;
+		}
+		char c = m_data[m_pos];
+		if(c == '?')
+		{
+			// <?xml version="1.0" encoding="UTF-8"?>
+			if(!skipTo("?>", 2))
+			{
+				m_type = NeedData;
+				return m_type;
+			}
+			continue;
+		}
+		if(c == '!')
+		{
+			bool done = false;
+			if((m_pos + 3 <= m_size) && (memcmp(m_data + m_pos, "!--", 3) == 0))
+				done = skipTo("-->", 3);
+			else
+				done = skipTo(">", 1);
+			if(!done)
+			{
+				m_type = NeedData;
+				return m_type;
+			}
+			continue;
+		}
+		m_type = readTag(end);
+		if(m_type == NeedData)
+			m_empty_elem = false;
+		return m_type;
+	}
+	m_type = NoToken;
+	return m_type;
+}
+
+static int hexValue(char c)
+{
+	if((c >= '0') && (c <= '9'))
+		return c - '0';
+	if((c >= 'a') && (c <= 'f'))
+		return c - 'a' + 10;
+	if((c >= 'A') && (c <= 'F'))
+		return c - 'A' + 10;
+	return -1;
+}
+
+// static
+QString TrOsmXmlScan::toString(const OsmView_t & view)
+{
+	if((view.ptr == nullptr) || (view.len <= 0))
+		return QString();
+
+	if(memchr(view.ptr, '&', view.len) == nullptr)
+		return QString::fromUtf8(view.ptr, view.len);
+
+	QByteArray out;
+	out.reserve(view.len);
+	const char * act = view.ptr;
+	const char * end = view.ptr + view.len;
+	while(act < end)
+	{
+		if(*act != '&')
+		{
+			out.append(*act++);
+			continue;
+		}
+		const char * semi = static_cast<const char *>(memchr(act, ';', end - act));
+		if(semi == nullptr)
+		{
+			out.append(act, static_cast<int>(end - act));
+			break;
+		}
+		OsmView_t ent = osmView(act + 1, static_cast<int32_t>(semi - act - 1));
+		if(osmViewIs(ent, "amp"))
+			out.append('&');
+		else if(osmViewIs(ent, "lt"))
+			out.append('<');
+		else if(osmViewIs(ent, "gt"))
+			out.append('>');
+		else if(osmViewIs(ent, "quot"))
+			out.append('"');
+		else if(osmViewIs(ent, "apos"))
+			out.append('\'');
+		else if((ent.len > 1) && (ent.ptr[0] == '#'))
+		{
+			uint32_t code = 0;
+			bool hex = ((ent.ptr[1] == 'x') || (ent.ptr[1] == 'X'));
+			for(int i = (hex ? 2 : 1); i < ent.len; i++)
+			{
+				int d = hex ? hexValue(ent.ptr[i]) : (ent.ptr[i] - '0');
+				if((d < 0) || (d > (hex ? 15 : 9)))
+					break;
+				code = code * (hex ? 16 : 10) + d;
+			}
+			QString uc = QString::fromUcs4(&code, 1);
+			out.append(uc.toUtf8());
+		}
+		else
+		{
+			// unknown entity, keep it
+			out.append(act, static_cast<int>(semi - act + 1));
+		}
+		act = semi + 1;
+	}
+	return QString::fromUtf8(out);
+}
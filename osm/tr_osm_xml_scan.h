@@ -0,0 +1,115 @@
+/******************************************************************
+ *
+ * @short	tokenizer for the OSM subset of XML
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TrOsmXmlScan
+ * superclass:	---
+ * modul:	tr_osm_xml_scan.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+
+#ifndef TR_OSM_XML_SCAN_H
+#define TR_OSM_XML_SCAN_H
+
+#include <QtCore/qstring.h>
+
+#include "osm_view.h"
+
+#include <stddef.h>
+
+// more attributes are ignored, OSM elements are using less than 10
+#define OSM_SCAN_MAX_ATTR  16
+
+// Works directly on the bytes of the (mapped) file, nothing is copied.
+// Only the part of XML used by OSM files is handled: elements with
+// attributes, declarations and comments, no text content.
+// The usage follows QXmlStreamReader: readNext() until atEnd(),
+// an empty element <nd ref="1"/> returns a start and an end element.
+class TrOsmXmlScan
+{
+public:
+	enum TokenType
+	{
+		NoToken = 0,
+		StartElement,
+		EndElement,
+		// the element is not complete inside of the buffer
+		NeedData,
+		Invalid
+	};
+
+private:
+	const char * m_data;
+	size_t m_size;
+	size_t m_pos;
+	// start position of the last token
+	size_t m_token_pos;
+
+	TokenType m_type;
+	bool m_empty_elem;
+
+	OsmView_t m_name;
+	OsmView_t m_keys[OSM_SCAN_MAX_ATTR];
+	OsmView_t m_values[OSM_SCAN_MAX_ATTR];
+	int m_n_attr;
+
+	QString m_error;
+
+	TokenType readTag(const char * end);
+	bool skipTo(const char * pattern, size_t len);
+
+public:
+	TrOsmXmlScan();
+	virtual ~TrOsmXmlScan();
+
+	void setData(const char * data, size_t size);
+
+	TokenType readNext();
+
+	bool atEnd() const;
+
+	bool isStartElement() const;
+	bool isEndElement() const;
+	bool hasError() const;
+
+	const OsmView_t & name() const;
+
+	bool attribute(const char * key, OsmView_t & value) const;
+
+	// position of the last token, used to continue on a new buffer
+	size_t tokenPosition() const;
+
+	QString errorString() const;
+
+	// resolves the XML entities ('&amp;'...) and converts from UTF-8
+	static QString toString(const OsmView_t & view);
+};
+
+#endif // TR_OSM_XML_SCAN_H
@@ -0,0 +1,708 @@
+/******************************************************************
+ *
+ * @short	table lookup of the tag values against the old compare chains
+ *
+ * project:	Trafalgar/OSM
+ *
+ * class:	TstOsmTagClass
+ * superclass:	QObject
+ * modul:	tst_osm_tag_class.cpp
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2024-2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+#include <QtTest/QtTest>
+
+#include "tr_import_osm_rel.h"
+#include "tr_import_osm_stream.h"
+
+#include "osm_load.h"
+#include "osm_load_rel.h"
+
+#include <tr_prof_class_def.h>
+
+// the compare chains before the tables of osm_tag_hash.h, unchanged
+static uint64_t oldBarrierClass(const QString & value)
+{
+	if(value == "guard_rail")
+		return 1;
+
+	//TR_INF << value;
+	if(value == "gate")
+		return (FLAG_FEATURE_NODE | 2);
+	if(value == "bollard")
+		return (FLAG_FEATURE_NODE | 3);
+	if(value == "entrance")
+		return (FLAG_FEATURE_NODE | 2);
+	return 0;
+}
+
+static uint64_t oldBuildingClass(const QString & value)
+{
+	if(value == "yes")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "house")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "bungalow")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "terrace")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "detached")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "semidetached_house")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "residential")
+		return (BUILDING_APAR | FLAG_FEATURE_AERA);
+	if(value == "apartments")
+		return (BUILDING_APAR | FLAG_FEATURE_AERA);
+	if(value == "dormitory")
+		return (BUILDING_APAR | FLAG_FEATURE_AERA);
+	if(value == "retail")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "office")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "commercial")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "warehouse")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "roof")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "bridge")
+		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+	if(value == "kiosk")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "church")
+		return (BUILDING_REL | FLAG_FEATURE_AERA);
+	if(value == "chapel")
+		return (BUILDING_REL | FLAG_FEATURE_AERA);
+	if(value == "public")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "civic")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "school")
+		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
+	if(value == "hospital")
+		return (BUILDING_MEDI | FLAG_FEATURE_AERA);
+	if(value == "fire_station")
+		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+	if(value == "kindergarten")
+		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
+	if(value == "industrial")
+		return (BUILDING_INDUST | FLAG_FEATURE_AERA);
+	if(value == "farm")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "farm_auxiliary")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "barn")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "cowshed")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "stable")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+    if(value == "allotment_house")
+        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+    if(value == "hut")
+        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+    if(value == "sports_centre")
+        return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+    if(value == "greenhouse")
+    {
+        return (BUILDING_INDUST | FLAG_FEATURE_AERA);
+    }
+    if(value == "garage")
+		return (BUILDING_CAR | FLAG_FEATURE_AERA);
+	if(value == "garages")
+		return (BUILDING_CAR | FLAG_FEATURE_AERA);
+	if(value == "carport")
+		return (BUILDING_CAR | FLAG_FEATURE_AERA);
+	if(value == "parking")
+		return (BUILDING_CAR | FLAG_FEATURE_AERA);
+	if(value == "hotel")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "government")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "museum")
+		return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+	if(value == "university")
+		return (BUILDING_LEARN | FLAG_FEATURE_AERA);
+	if(value == "ruins")		// TODO: new building class?
+		return (BUILDING_RUINS | FLAG_FEATURE_AERA);
+	if(value == "shed")
+		return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+	if(value == "guardhouse")
+		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+	if(value == "service")
+		return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+    if(value == "chalet")
+    {
+        return (BUILDING_HOUSE | FLAG_FEATURE_AERA);
+    }
+    if(value == "sports_hall")
+    {
+        return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+    }
+    if(value == "clinic")
+    {
+        return (BUILDING_PUBLIC | FLAG_FEATURE_AERA);
+    }
+    if(value == "water_tower")
+    {
+        return (BUILDING_SERVICE | FLAG_FEATURE_AERA);
+    }
+    return (0x0007 | FLAG_FEATURE_AERA);
+}
+
+static uint64_t oldHighwayPointClass(const QString & value)
+{
+	if(value == "level_crossing")
+		return (1 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "crossing")
+		return (1 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "street_lamp")
+		return 2;
+	if(value == "traffic_signals")
+		return (7 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "bus_stop")
+		return (8 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "turning_circle")
+		return (6 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	return 0;
+}
+
+static uint64_t oldRailwayPointClass(const QString & value)
+{
+	if(value == "milestone")
+		return 1;
+	if(value == "switch")
+		return 1;
+	if(value == "level_crossing")
+		return 1;
+	if(value == "crossing")
+		return 1;
+	if(value == "railway_crossing")
+		return 1;
+	if(value == "tram_crossing")
+		return 1;
+	if(value == "tram_level_crossing")
+		return 1;
+	if(value == "buffer_stop")
+		return 1;
+	if(value == "stop")
+		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
+	if(value == "tram_stop")
+		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
+	if(value == "station")
+		return (8 | FLAG_FEATURE_NODE | TYPE_RAIL);
+	if(value == "signal")
+		return (7 | FLAG_FEATURE_NODE | TYPE_RAIL);
+	return 0;
+}
+
+static uint64_t oldAmenityClass(const QString & value)
+{
+	//TR_INF << value;
+	if(value == "bench")
+		return (1);
+	if(value == "waste_basket")
+		return (1);
+	if(value == "recycling")
+		return (1);
+	if(value == "fountain")
+		return (1);
+	if(value == "hunting_stand")
+		return (1);
+	if(value == "parking")
+		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "bicycle_parking")
+		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "parking_entrance")
+		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "vending_machine")
+		return (2 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "restaurant")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "cafe")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "bar")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "pub")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "fast_food")	// POI
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "canteen")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "doctors")
+		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "veterinary")
+		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "dentist")
+		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "pharmacy")
+		return (5 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "post_box")
+		return (6 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "kindergarten")
+		return (6 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "place_of_worship")
+		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "shelter")
+		return (4 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "fuel")
+		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "charging_station")
+		return (6 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	if(value == "taxi")
+		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
+	return 0;
+}
+
+static uint64_t oldShopClass(const QString & value)
+{
+	if(value == "vacant")
+		return 1;
+	//shop' v='kiosk
+	if(value == "kiosk")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "supermarket")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "convenience")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "beverages")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "wine")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "bakery")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "butcher")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "florist")
+		return (1 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "beauty")
+		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "laundry")
+		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "hairdresser")
+		return (3 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "electronics")
+		return (4 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "clothes")
+		return (2 | FLAG_FEATURE_NODE | TYPE_PUBLIC);
+	if(value == "car_repair")
+		return (5 | FLAG_FEATURE_NODE | TYPE_ROAD);
+
+	//"bicycle"
+	return 0;
+}
+
+static uint64_t oldLanduseClass(const QString & value)
+{
+	if(value == "forest")
+		return (LANDUSE_WOOD  | FLAG_FEATURE_AERA);
+	if(value == "grass")            // secondary layer
+		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
+	if(value == "recreation_ground")
+		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
+	if(value == "meadow")
+		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
+	if(value == "village_green")
+		return (LANDUSE_BUSHES | FLAG_FEATURE_AERA);
+	if(value == "farmland")
+		return (LANDUSE_BUSHES | FLAG_FEATURE_AERA);
+	if(value == "commercial")       // base layer?
+		return (LANDUSE_MIXED | FLAG_FEATURE_AERA);
+	if(value == "residential")      // base layer
+		return (LANDUSE_RESIDENTIAL | FLAG_FEATURE_AERA);
+	if(value == "construction")     // secondary layer?
+		return (LANDUSE_INDUSTRIAL | FLAG_FEATURE_AERA);
+	return 0;
+}
+
+static uint64_t oldNaturalClass(const QString & value)
+{
+	if(value == "wood")
+		//return (NATURAL_FOREST | FLAG_FEATURE_AERA);
+		return (LANDUSE_WOOD  | FLAG_FEATURE_AERA);
+	if(value == "grassland")
+		return (LANDUSE_GRASS | FLAG_FEATURE_AERA);
+	if(value == "water")
+		return (NATURAL_WATER | FLAG_FEATURE_AERA);
+	if(value == "shingle")
+		return (NATURAL_WET | FLAG_FEATURE_AERA);
+
+	if(value == "tree")	// POI
+	{
+		//TR_INF << "-----tree------";
+		return (8 | FLAG_FEATURE_NODE | TYPE_POI_N_TREE | TYPE_NATURAL);
+	}
+	return 0;
+}
+
+static uint64_t oldWaterWayClass(const QString & value)
+{
+	if(value == "river")
+		return (WATER_RIVER | FLAG_FEATURE_AERA);
+	if(value == "stream")
+		return (WATER_STREAM | FLAG_FEATURE_AERA); //FLAG_FEATURE_WAY);
+	return 0;
+}
+
+static uint64_t oldRailWayClass(const QString & value)
+{
+    if(value == "rail")
+        return 0x0000000000000080;
+    if(value == "subway")
+        return 0x0000000000000090;
+    if(value == "light_rail")
+        return 0x00000000000000A0;
+    if(value == "tram")
+        return 0x00000000000000A0;
+    if(value == "narrow_gauge")
+        return 0x00000000000000B0;
+    return 0;
+}
+
+static uint64_t oldClass(const QString & value)
+{
+	uint64_t ret = 0;
+
+	if(value == "service")
+		return 0x0000000000000009;
+	if(value == "escape")
+		return 0x0000000000000009;
+	if(value == "bus_guideway")
+		return 0x0000000000000009;
+
+	if(value == "track")
+		return 0x000000000000000A;
+
+	if(value == "path")
+		return 0x000000000000000B;
+	if(value == "bridleway")
+		return 0x000000000000000B;
+	if(value == "footway")
+		return 0x000000000000000F;
+	if(value == "cycleway")
+		return 0x000000000000000C;
+	if(value == "steps")
+		return 0x000000000000000D;
+
+	if(value == "pedestrian")
+		return 0x000000000000000E;
+
+	if(value.endsWith("_link"))
+	{
+		ret |= FLAG_RAMP;
+	}
+	if(value.startsWith("motorway"))
+		return (ret | 0x0000000000000001);
+
+	if(value.startsWith("trunk"))
+		return (ret | 0x0000000000000002);
+
+	if(value.startsWith("primary"))
+		return (ret | 0x0000000000000003);
+
+	if(value.startsWith("secondary"))
+		return (ret | 0x0000000000000004);
+
+	if(value.startsWith("tertiary"))
+		return (ret | 0x0000000000000005);
+
+	if(value.startsWith("unclassified"))
+		return (ret | 0x0000000000000006);
+
+	if(value.startsWith("residential"))
+		return (ret | 0x0000000000000007);
+
+	if(value.startsWith("living_street"))
+		return (ret | 0x0000000000000008);
+
+	return 0;
+}
+
+// all values of the old chains and of the tables, the prefix fallbacks
+// of the highway class and some values which are not in any list
+static const char * s_values[] =
+{
+	"",
+	"Service",
+	"_link",
+	"allotment_house",
+	"apartments",
+	"bakery",
+	"bar",
+	"barn",
+	"beauty",
+	"bench",
+	"beverages",
+	"bicycle_parking",
+	"bollard",
+	"bridge",
+	"bridleway",
+	"buffer_stop",
+	"bungalow",
+	"bus_guideway",
+	"bus_stop",
+	"butcher",
+	"cafe",
+	"canteen",
+	"car_repair",
+	"carport",
+	"chalet",
+	"chapel",
+	"charging_station",
+	"church",
+	"civic",
+	"clinic",
+	"clothes",
+	"commercial",
+	"construction",
+	"convenience",
+	"cowshed",
+	"crossing",
+	"cycleway",
+	"dentist",
+	"detached",
+	"doctors",
+	"dormitory",
+	"electronics",
+	"entrance",
+	"escape",
+	"farm",
+	"farm_auxiliary",
+	"farmland",
+	"fast_food",
+	"fire_station",
+	"florist",
+	"footway",
+	"footway_link",
+	"forest",
+	"fountain",
+	"fuel",
+	"garage",
+	"garages",
+	"gate",
+	"government",
+	"grass",
+	"grassland",
+	"greenhouse",
+	"guard_rail",
+	"guardhouse",
+	"hairdresser",
+	"hospital",
+	"hotel",
+	"house",
+	"house_boat",
+	"hunting_stand",
+	"hut",
+	"industrial",
+	"kindergarten",
+	"kiosk",
+	"laundry",
+	"level_crossing",
+	"light_rail",
+	"link",
+	"living_street",
+	"living_street_link",
+	"meadow",
+	"milestone",
+	"motorway",
+	"motorway_junction",
+	"motorway_link",
+	"museum",
+	"narrow_gauge",
+	"office",
+	"parking",
+	"parking_entrance",
+	"path",
+	"pedestrian",
+	"pharmacy",
+	"place_of_worship",
+	"post_box",
+	"primary",
+	"primary_construction",
+	"primary_link",
+	"pub",
+	"public",
+	"rail",
+	"rail_road",
+	"railway_crossing",
+	"recreation_ground",
+	"recycling",
+	"residential",
+	"residential_link",
+	"restaurant",
+	"retail",
+	"river",
+	"roof",
+	"ruins",
+	"school",
+	"secondary",
+	"secondary_link",
+	"semidetached_house",
+	"service",
+	"service ",
+	"shed",
+	"shelter",
+	"shingle",
+	"signal",
+	"sports_centre",
+	"sports_hall",
+	"stable",
+	"station",
+	"steps",
+	"stop",
+	"stream",
+	"street_lamp",
+	"subway",
+	"supermarket",
+	"switch",
+	"taxi",
+	"terrace",
+	"tertiary",
+	"tertiary_link",
+	"track",
+	"traffic_signals",
+	"tram",
+	"tram_crossing",
+	"tram_level_crossing",
+	"tram_stop",
+	"tree",
+	"treetop",
+	"trunk",
+	"trunk_link",
+	"turning_circle",
+	"unclassified",
+	"unclassified_link",
+	"unclassified_road",
+	"university",
+	"unknown",
+	"vacant",
+	"vending_machine",
+	"veterinary",
+	"village_green",
+	"warehouse",
+	"waste_basket",
+	"water",
+	"water_tower",
+	"wine",
+	"wood",
+	"yes",
+	"yes_please",
+};
+
+class TstOsmTagClass : public QObject
+{
+	Q_OBJECT
+
+private:
+	void compare(uint64_t (*old_class)(const QString &), uint64_t (*new_class)(const QString &));
+
+private slots:
+	void highwayClass();
+	void barrierClass();
+	void buildingClass();
+	void highwayPointClass();
+	void railwayPointClass();
+	void amenityClass();
+	void shopClass();
+	void landuseClass();
+	void naturalClass();
+	void waterWayClass();
+	void railWayClass();
+};
+
+void TstOsmTagClass::compare(uint64_t (*old_class)(const QString &), uint64_t (*new_class)(const QString &))
+{
+	for(size_t i = 0; i < sizeof(s_values) / sizeof(s_values[0]); i++)
+	{
+		QString value = QString::fromLatin1(s_values[i]);
+		uint64_t old_code = old_class(value);
+		uint64_t new_code = new_class(value);
+		if(old_code != new_code)
+			qWarning() << "value:" << value << "old:" << HEX << old_code << "new:" << new_code;
+		QCOMPARE(new_code, old_code);
+	}
+}
+
+void TstOsmTagClass::highwayClass()
+{
+	compare(oldClass, TrImportOsmStream::getClass);
+}
+
+void TstOsmTagClass::barrierClass()
+{
+	compare(oldBarrierClass, TrImportOsmRel::getBarrierClass);
+}
+
+void TstOsmTagClass::buildingClass()
+{
+	compare(oldBuildingClass, TrImportOsmRel::getBuildingClass);
+}
+
+void TstOsmTagClass::highwayPointClass()
+{
+	compare(oldHighwayPointClass, TrImportOsmRel::getHighwayPointClass);
+}
+
+void TstOsmTagClass::railwayPointClass()
+{
+	compare(oldRailwayPointClass, TrImportOsmRel::getRailwayPointClass);
+}
+
+void TstOsmTagClass::amenityClass()
+{
+	compare(oldAmenityClass, TrImportOsmRel::getAmenityClass);
+}
+
+void TstOsmTagClass::shopClass()
+{
+	compare(oldShopClass, TrImportOsmRel::getShopClass);
+}
+
+void TstOsmTagClass::landuseClass()
+{
+	compare(oldLanduseClass, TrImportOsmRel::getLanduseClass);
+}
+
+void TstOsmTagClass::naturalClass()
+{
+	compare(oldNaturalClass, TrImportOsmRel::getNaturalClass);
+}
+
+void TstOsmTagClass::waterWayClass()
+{
+	compare(oldWaterWayClass, TrImportOsmRel::getWaterWayClass);
+}
+
+void TstOsmTagClass::railWayClass()
+{
+	compare(oldRailWayClass, TrImportOsmRel::getRailWayClass);
+}
+
+QTEST_APPLESS_MAIN(TstOsmTagClass)
+
+#include "tst_osm_tag_class.moc"
@@ -0,0 +1,59 @@
+# table lookup of the tag values (osm_tag_hash.h) against the old compare chains
+# qmake && make && ./tst_osm_tag_class
+
+QT       += core gui xml testlib
+QT       += concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_osm_tag_class
+
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
+
+LIBS += -lz
+LIBS += -lbz2
+
+ROOT = $$PWD/../..
+
+INCLUDEPATH += $$ROOT/geo
+INCLUDEPATH += $$ROOT/osm
+INCLUDEPATH += $$ROOT/trafalgar
+
+# the OSM import and the map classes, without the application
+SOURCES += \
+    tst_osm_tag_class.cpp \
+    $$ROOT/geo/geo_base.cpp \
+    $$ROOT/geo/geo_globe.cpp \
+    $$ROOT/geo/geo_lin.cpp \
+    $$ROOT/geo/geo_poly.cpp \
+    $$ROOT/geo/geo_ref.cpp \
+    $$ROOT/osm/tr_import_osm_o5m.cpp \
+    $$ROOT/osm/tr_import_osm_pbf.cpp \
+    $$ROOT/osm/tr_import_osm_rel.cpp \
+    $$ROOT/osm/tr_import_osm_stream.cpp \
+    $$ROOT/osm/tr_osm_clip.cpp \
+    $$ROOT/osm/tr_osm_id_set.cpp \
+    $$ROOT/osm/tr_osm_inflate.cpp \
+    $$ROOT/osm/tr_osm_name_dict.cpp \
+    $$ROOT/osm/tr_osm_tag_pool.cpp \
+    $$ROOT/osm/tr_osm_xml_scan.cpp \
+    $$ROOT/trafalgar/tr_geo_object.cpp \
+    $$ROOT/trafalgar/tr_geo_point.cpp \
+    $$ROOT/trafalgar/tr_geo_poly.cpp \
+    $$ROOT/trafalgar/tr_geo_segment.cpp \
+    $$ROOT/trafalgar/tr_layer.cpp \
+    $$ROOT/trafalgar/tr_map_face.cpp \
+    $$ROOT/trafalgar/tr_map_link.cpp \
+    $$ROOT/trafalgar/tr_map_link_road.cpp \
+    $$ROOT/trafalgar/tr_map_list.cpp \
+    $$ROOT/trafalgar/tr_map_net.cpp \
+    $$ROOT/trafalgar/tr_map_net_road.cpp \
+    $$ROOT/trafalgar/tr_map_node.cpp \
+    $$ROOT/trafalgar/tr_map_node_pool.cpp \
+    $$ROOT/trafalgar/tr_map_poi.cpp \
+    $$ROOT/trafalgar/tr_name_element.cpp \
+    $$ROOT/trafalgar/tr_stack.cpp \
+    $$ROOT/trafalgar/tr_zoom_map.cpp
@@ -48,10 +48,12 @@
 TrGeoPolygon::TrGeoPolygon() 
 	: TrGeoObject()
 	, stdPen(nullptr)
+	, m_capacity(0)
 {
 	m_base.pt = nullptr;
 	m_base.n_pt = 0;
 	m_base.add = nullptr;
+	m_base.length = 0.0;
 }
 
 TrGeoPolygon::~TrGeoPolygon()
@@ -70,6 +72,7 @@ void TrGeoPolygon::clearData()
 	//TR_MSG;
 	geoPoly2DDelete(&m_base);
 	m_base.n_pt = 0;
+	m_capacity = 0;
 }
 
 // static
@@ -355,32 +358,63 @@ void TrGeoPolygon::draw(const TrZoomMap & zoom_ref, QPainter * p, TrPoint from,
 
 void TrGeoPolygon::appendPoints(const QVector<TrPoint> & next_points)
 {
-	QVector<TrPoint> poly_points;
+	appendPoints(next_points.constData(), static_cast<size_t>(next_points.size()));
+}
 
-	for (unsigned int i = 0; i < m_base.n_pt; ++i)
+void TrGeoPolygon::appendPoints(const TrPoint * next_points, size_t n)
+{
+	if(!reservePoints(m_base.n_pt + n))
+		return;
+
+	double * pt = m_base.pt + (m_base.n_pt * 2);
+	for (size_t i = 0; i < n; ++i)
 	{
-		TrPoint pt;
-		pt.x = m_base.pt[i*2];
-		pt.y = m_base.pt[(i*2)+1];
-		poly_points.append(pt);
+		pt[i*2] = next_points[i].x;
+		pt[(i*2)+1] = next_points[i].y;
 	}
+	m_base.n_pt += static_cast<unsigned int>(n);
+	clearSegments();
+}
 
-	//poly_points.append(next_point);
-	poly_points += next_points;
-
-	if(m_base.pt != nullptr)
+void TrGeoPolygon::appendPoint(const TrPoint & pt)
+{
+	if(m_base.n_pt >= m_capacity)
 	{
-		delete m_base.pt;
-		m_base.pt = nullptr;
+		if(!reservePoints(m_capacity < 4 ? 4 : m_capacity * 2))
+			return;
 	}
+	m_base.pt[m_base.n_pt*2] = pt.x;
+	m_base.pt[(m_base.n_pt*2)+1] = pt.y;
+	m_base.n_pt++;
+	clearSegments();
+}
+
+// place for 'n' points, the points are kept
+bool TrGeoPolygon::reservePoints(size_t n)
+{
+	if(n <= m_capacity)
+		return true;
 
-	geoPoly2DNew(&m_base, poly_points.size());
+	double * pt = static_cast<double *>(realloc(m_base.pt, sizeof(double) * 2 * n));
+	if(pt == nullptr)
+	{
+		TR_ERR << "no memory for" << n << "points";
+		return false;
+	}
+	m_base.pt = pt;
+	m_capacity = n;
+	return true;
+}
 
-	for (int i = 0; i < poly_points.size(); ++i)
+// the segments are calculated by 'setInfo'
+void TrGeoPolygon::clearSegments()
+{
+	if(m_base.add != nullptr)
 	{
-		m_base.pt[i*2] = poly_points.at(i).x;
-		m_base.pt[(i*2)+1] = poly_points.at(i).y;
+		free(m_base.add);
+		m_base.add = nullptr;
 	}
+	m_base.length = 0.0;
 }
 
 bool TrGeoPolygon::setSurroundingRect()
@@ -525,7 +559,9 @@ int TrGeoPolygon::parallel(TrGeoPolygon * base, const TrZoomMap & zoom_ref, int3
 	}
 	par_line.append(pt);
 
+	clearData();
 	geoPoly2DNew(&m_base, par_line.size());
+	m_capacity = m_base.n_pt;
 	for(int i=0; i < par_line.size(); i++)
 	{
 		m_base.pt[i*2] = par_line[i].x;
@@ -928,7 +964,9 @@ uint64_t TrGeoPolygon::readXmlDescription(QXmlStreamReader & xml_in)
 					start_x = poly_points[i].x;
 					start_y = poly_points[i].y;
 				}
+				clearData();
 				geoPoly2DNew(&m_base, poly_points.size());
+				m_capacity = m_base.n_pt;
 				for(int i=0; i<poly_points.size(); i++)
 				{
 					m_base.pt[i*2] = poly_points[i].x;
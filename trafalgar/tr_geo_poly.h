@@ -57,6 +57,10 @@ class TrGeoPolygon : public TrGeoObject
 private:
 	QPen * stdPen;
     poly_base m_base;
+	// allocated points of 'm_base.pt'
+	size_t m_capacity;
+
+	void clearSegments();
 
 	bool readXmlPoint(QXmlStreamReader & xml_in, QVector<TrPoint> & poly_points);
 
@@ -109,6 +113,13 @@ public:
 
 	void appendPoints(const QVector<TrPoint> & next_points);
 
+	void appendPoints(const TrPoint * next_points, size_t n);
+
+	// amortized O(1), the segment data is removed
+	void appendPoint(const TrPoint & pt);
+
+	bool reservePoints(size_t n);
+
 	bool setSurroundingRect();
 
 	void setInfo(const TrZoomMap & zoom_ref);
@@ -147,9 +147,7 @@ void TrMapFace::draw(const TrZoomMap & zoom_ref, QPainter * p, unsigned char mod
 
 void TrMapFace::appendPolyPoint(TrPoint pt)
 {
-	QVector<TrPoint> next_points;
-	next_points.append(pt);
-	m_pline->appendPoints(next_points);
+	m_pline->appendPoint(pt);
 }
 
 void TrMapFace::appendPolygon(uint8_t flags)
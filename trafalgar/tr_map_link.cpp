@@ -310,6 +310,16 @@ bool TrMapLink::isAsDoubleLine()
 	return ((getRdClass() & 0x00ff) < 9);
 }
 
+bool TrMapLink::isMergeable(TrMapLink & next)
+{
+	// the direction of the polygon doesn't matter
+	uint8_t dir_mask = static_cast<uint8_t>(~TR_LINK_DIR_BWD);
+
+	return ((m_type == next.m_type) && (m_name_id == next.m_name_id) &&
+		(m_mm_load_width == next.m_mm_load_width) &&
+		((m_one_way & dir_mask) == (next.m_one_way & dir_mask)));
+}
+
 // TODO: function: check if ramp is needed...
 
 // TODO: check! -> called from readXmlDescription
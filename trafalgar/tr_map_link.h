@@ -158,6 +158,9 @@ public:
 
 	bool isAsDoubleLine();
 
+	// same attributes in the direction of travel, see TrMapNet::mergeChains
+	virtual bool isMergeable(TrMapLink & next);
+
 	// only for osm filter
 	bool appendPolyPoint(TrPoint & pt);
 
@@ -107,6 +107,16 @@ uint16_t TrMapLinkRoad::getParking()
 	return m_parking;
 }
 
+bool TrMapLinkRoad::isMergeable(TrMapLink & next)
+{
+	TrMapLinkRoad * next_rd = dynamic_cast<TrMapLinkRoad *>(&next);
+
+	if(next_rd == nullptr)
+		return false;
+	return (TrMapLink::isMergeable(next) && (m_lanes == next_rd->m_lanes) &&
+		(m_parking == next_rd->m_parking));
+}
+
 
 bool TrMapLinkRoad::getSegment(TrGeoSegment & seg, bool dir, bool par)
 {
@@ -115,6 +115,8 @@ public:
 
 	uint16_t getParking();
 
+	virtual bool isMergeable(TrMapLink & next);
+
 	virtual bool getSegment(TrGeoSegment & seg, bool dir, bool par);
 
 	virtual bool getParSegment(const TrZoomMap & zoom_ref, poly_add & add, bool dir);
@@ -337,6 +337,26 @@ bool TrMapList::appendObject(TrGeoObject * list_obj, uint64_t key)
 	return false;
 }
 
+int TrMapList::appendObjects(const QVector<TrGeoObject *> & list_objs, uint64_t first_key)
+{
+	int count = 0;
+	// behind the last key: no search, the objects are added at the end
+	bool at_end = obj_map.isEmpty() || ((obj_map.constEnd() - 1).key() < first_key);
+	for(int i = 0; i < list_objs.size(); i++)
+	{
+		if(at_end)
+		{
+			obj_map.insert(obj_map.constEnd(), first_key + i, list_objs[i]);
+			count++;
+		}
+		else if(appendObject(list_objs[i], first_key + i))
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
 bool TrMapList::deleteObject(const uint64_t key)
 {
 	if(obj_list.size())
@@ -354,6 +374,20 @@ bool TrMapList::deleteObject(const uint64_t key)
 	return false;
 }
 
+int TrMapList::removeVecObjects(const QSet<TrGeoObject *> & objs)
+{
+	int n = 0;
+
+	for (int i = 0; i < obj_list.size(); ++i)
+	{
+		if(!objs.contains(obj_list.at(i)))
+			obj_list[n++] = obj_list.at(i);
+	}
+	int removed = obj_list.size() - n;
+	obj_list.resize(n);
+	return removed;
+}
+
 bool TrMapList::appendObjectPen(int idx, QPen pen)
 {
 	m_objPenMap[idx] = pen;
@@ -46,6 +46,7 @@
 #include <stdint.h>
 
 #include <QtCore/qmap.h>
+#include <QtCore/qset.h>
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
 
@@ -118,8 +119,14 @@ public:
 
 	bool appendObject(TrGeoObject * list_obj, uint64_t key);
 
+	// keys 'first_key', 'first_key' + 1 ..., returns the number of new keys
+	int appendObjects(const QVector<TrGeoObject *> & list_objs, uint64_t first_key);
+
 	bool deleteObject(const uint64_t key);
 
+	// from the vector, the objects are not deleted
+	int removeVecObjects(const QSet<TrGeoObject *> & objs);
+
 	bool addPen(const QString & group, int idx, const QPen & pen);
 
 	bool appendObjectPen(int idx, QPen pen);
@@ -40,6 +40,11 @@
 #include "tr_map_node.h"
 #include "tr_map_link_road.h"
 
+#include <algorithm>
+#include <string.h>
+
+#include <QtCore/qhash.h>
+
 // Segment: for debug output drawing used for cross point
 //TrGeoSegment * TrMapNet::ms_seg_1 = new TrGeoSegment;
 //TrGeoSegment * TrMapNet::ms_seg_2 = new TrGeoSegment;
@@ -52,6 +57,7 @@ TrMapNet::TrMapNet()
 	, m_node_map(nullptr)
 	, m_primive_map(nullptr)
 	, m_complex_map(nullptr)
+	, m_pool_net(-1)
 {
 }
 
@@ -548,6 +554,260 @@ bool TrMapNet::createNodeInOut()
         return true;
 }
 
+// points of the link in the direction of travel
+static void getTravelPoints(TrMapLink * link, QVector<TrPoint> & points)
+{
+	points.clear();
+	TrGeoPolygon * poly = link->getPolygon();
+	if(poly == nullptr)
+		return;
+
+	poly->getPoints(points);
+	if(link->getOneWay() & TR_LINK_DIR_BWD)
+		std::reverse(points.begin(), points.end());
+}
+
+static void addChainLink(TrChainNode & cn, TrMapLink * link, bool dir)
+{
+	if(dir == TR_NODE_IN)
+	{
+		if(cn.n_in < 2)
+			cn.in[cn.n_in] = link;
+		if(cn.n_in < 3)
+			cn.n_in++;
+	}
+	else
+	{
+		if(cn.n_out < 2)
+			cn.out[cn.n_out] = link;
+		if(cn.n_out < 3)
+			cn.n_out++;
+	}
+}
+
+static void replaceChainLink(TrMapLink ** links, uint8_t n, TrMapLink * old_link, TrMapLink * new_link)
+{
+	for (int i = 0; i < n && i < 2; ++i)
+	{
+		if(links[i] == old_link)
+			links[i] = new_link;
+	}
+}
+
+int TrMapNet::mergeChains()
+{
+	if((m_node_map == nullptr) || (m_link_list == nullptr) || (m_primive_map == nullptr))
+		return 0;
+
+	QHash<TrMapNode *, TrChainNode> chain;
+	TrChainNode empty;
+	memset(&empty, 0x00, sizeof(empty));
+
+	for (size_t i = 0; i < m_link_list->objCount(); ++i)
+	{
+		TrMapLink * link = dynamic_cast<TrMapLink *>(m_link_list->getVecObject(i));
+		if((link == nullptr) || (link->getNodeFromRef() == nullptr) ||
+			(link->getNodeToRef() == nullptr))
+			continue;
+
+		QHash<TrMapNode *, TrChainNode>::iterator it = chain.find(link->getNodeFromRef());
+		if(it == chain.end())
+			it = chain.insert(link->getNodeFromRef(), empty);
+		addChainLink(it.value(), link, TR_NODE_OUT);
+
+		it = chain.find(link->getNodeToRef());
+		if(it == chain.end())
+			it = chain.insert(link->getNodeToRef(), empty);
+		addChainLink(it.value(), link, TR_NODE_IN);
+	}
+
+	QSet<TrGeoObject *> removed;
+	QVector<uint64_t> node_ids;
+	QVector<TrPoint> points;
+	QVector<TrPoint> first_points;
+	QVector<TrPoint> next_points;
+	QMap<uint64_t, TrGeoObject *> & prim_map = m_primive_map->getMap();
+	uint64_t next_prim = prim_map.isEmpty() ? 1 : prim_map.lastKey() + 1;
+	QMap<uint64_t, TrGeoObject *> & node_map = m_node_map->getMap();
+
+	// key order -> same result for each run
+	for (QMap<uint64_t, TrGeoObject *>::const_iterator ii = node_map.constBegin();
+		ii != node_map.constEnd(); ++ii)
+	{
+		TrMapNode * node = dynamic_cast<TrMapNode *>(ii.value());
+		QHash<TrMapNode *, TrChainNode>::iterator it = chain.find(node);
+		if((node == nullptr) || (it == chain.end()))
+			continue;
+
+		TrChainNode & cn = it.value();
+		if((cn.n_in != cn.n_out) || (cn.n_in == 0) || (cn.n_in > 2))
+			continue;
+
+		// 'in': a -> node, 'next': node -> b,
+		// both directions: 'back_in': b -> node, 'back_out': node -> a
+		TrMapLink * in = cn.in[0];
+		TrMapLink * next = nullptr;
+		TrMapLink * back_in = nullptr;
+		TrMapLink * back_out = nullptr;
+		TrMapNode * nd_a = in->getNodeFromRef();
+		TrMapNode * nd_b = nullptr;
+
+		if(cn.n_in == 1)
+		{
+			next = cn.out[0];
+			nd_b = next->getNodeToRef();
+		}
+		else
+		{
+			back_in = cn.in[1];
+			nd_b = back_in->getNodeFromRef();
+			for (int k = 0; k < 2; ++k)
+			{
+				if(cn.out[k]->getNodeToRef() == nd_b)
+					next = cn.out[k];
+				else if(cn.out[k]->getNodeToRef() == nd_a)
+					back_out = cn.out[k];
+			}
+			// the links of both directions share the polygon
+			if((next == nullptr) || (back_out == nullptr) ||
+				(back_out->getPolygon() != in->getPolygon()) ||
+				(back_in->getPolygon() != next->getPolygon()) ||
+				(!back_in->isMergeable(*back_out)))
+				continue;
+		}
+		if((next == in) || (nd_a == node) || (nd_b == node) || (nd_a == nd_b) ||
+			(!in->isMergeable(*next)))
+			continue;
+
+		TrGeoPolygon * poly = in->getPolygon();
+		TrGeoPolygon * next_poly = next->getPolygon();
+		if((poly != nullptr) && (poly == next_poly))
+			continue;
+
+		// the polygon of 'in' is kept in its direction
+		getTravelPoints(next, next_points);
+		first_points.clear();
+		if(poly != nullptr)
+			poly->getPoints(first_points);
+
+		points.clear();
+		if(!(in->getOneWay() & TR_LINK_DIR_BWD))
+		{
+			points += first_points;
+			points.append(node->getPoint());
+			points += next_points;
+		}
+		else
+		{
+			std::reverse(next_points.begin(), next_points.end());
+			points += next_points;
+			points.append(node->getPoint());
+			points += first_points;
+		}
+
+		if(poly == nullptr)
+		{
+			poly = new TrGeoPolygon;
+			m_primive_map->appendObject(poly, next_prim);
+			in->setPolygon(poly);
+			in->setGeoId(next_prim);
+			if(back_out != nullptr)
+			{
+				back_out->setPolygon(poly);
+				back_out->setGeoId(next_prim);
+			}
+			next_prim++;
+		}
+		poly->clearData();
+		poly->appendPoints(points);
+
+		if(next_poly != nullptr)
+		{
+			m_primive_map->deleteObject(next->getGeoId());
+			delete next_poly;
+		}
+
+		// 'true': node from, 'false': node to
+		TrChainNode & cn_b = chain[nd_b];
+		in->setNodeRef(nd_b, false);
+		replaceChainLink(cn_b.in, cn_b.n_in, next, in);
+		removed.insert(next);
+		if(back_out != nullptr)
+		{
+			back_out->setNodeRef(nd_b, true);
+			replaceChainLink(cn_b.out, cn_b.n_out, back_in, back_out);
+			removed.insert(back_in);
+		}
+		cn.n_in = cn.n_out = 0;
+		node_ids.append(ii.key());
+	}
+
+	m_link_list->removeVecObjects(removed);
+	for (QSet<TrGeoObject *>::const_iterator ii = removed.constBegin(); ii != removed.constEnd(); ++ii)
+	{
+		delete *ii;
+	}
+	for (int i = 0; i < node_ids.size(); ++i)
+	{
+		TrGeoObject * node = m_node_map->getMapObject(node_ids[i]);
+		m_node_map->deleteObject(node_ids[i]);
+		delete node;
+	}
+	TR_INF << m_name << "merged nodes:" << node_ids.size() << "links:" << removed.size();
+	return node_ids.size();
+}
+
+void TrMapNet::setNodePool(const QSharedPointer<TrMapNodePool> & pool, int pool_net)
+{
+	m_node_pool = pool;
+	m_pool_net = pool_net;
+}
+
+const TrMapNodePool * TrMapNet::getNodePool() const
+{
+	return m_node_pool.data();
+}
+
+// index join by the use masks of the pool, the node objects are found by the id
+int TrMapNet::joinNodes(TrMapNet & other, QVector<TrMapNode *> & nodes, QVector<TrMapNode *> & other_nodes)
+{
+	nodes.clear();
+	other_nodes.clear();
+	if((m_node_pool.isNull()) || (m_node_pool != other.m_node_pool) || (m_pool_net == other.m_pool_net))
+		return 0;
+	if((m_node_map == nullptr) || (other.m_node_map == nullptr))
+		return 0;
+
+	QVector<int> slots = m_node_pool->join(m_pool_net, other.m_pool_net);
+	for(int i = 0; i < slots.size(); ++i)
+	{
+		uint64_t id = m_node_pool->getId(slots[i]);
+		// maybe removed by 'mergeChains'
+		TrMapNode * node = dynamic_cast<TrMapNode *>(m_node_map->getMapObject(id));
+		TrMapNode * other_node = dynamic_cast<TrMapNode *>(other.m_node_map->getMapObject(id));
+		if((node != nullptr) && (other_node != nullptr))
+		{
+			nodes.append(node);
+			other_nodes.append(other_node);
+		}
+	}
+	return nodes.size();
+}
+
+int TrMapNet::markSharedNodes(TrMapNet & other)
+{
+	QVector<TrMapNode *> nodes;
+	QVector<TrMapNode *> other_nodes;
+
+	int n_shared = joinNodes(other, nodes, other_nodes);
+	for(int i = 0; i < n_shared; ++i)
+	{
+		nodes[i]->setSharedNode(true);
+		other_nodes[i]->setSharedNode(true);
+	}
+	return n_shared;
+}
+
 #ifdef TR_SERIALIZATION
 uint64_t TrMapNet::readXmlDescription(QXmlStreamReader & xml_in)
 {
@@ -49,6 +49,8 @@
 
 #include "tr_map_link.h"
 
+#include "tr_map_node_pool.h"
+
 #ifdef TESTX
 #include "tr_map_edge.h"
 #endif
@@ -58,9 +60,23 @@
 
 #include <stdint.h>
 
+#include <QSharedPointer>
+
 #define LIST_DELETE true
 #define LIST_CREATE false
 
+// links of a node while the chains are merged
+typedef struct
+{
+	TrMapLink * in[2];
+	TrMapLink * out[2];
+	// up to 3: more than 2
+	uint8_t n_in;
+	uint8_t n_out;
+}TrChainNode;
+
+class TrMapNode;
+
 class TrMapNet : public TrGeoObject
 {
 private:
@@ -77,6 +93,10 @@ protected:
 	TrMapList * m_primive_map;
 	TrMapList * m_complex_map;
 
+	// shared with the other nets of the import, 'm_pool_net': bit in the pool
+	QSharedPointer<TrMapNodePool> m_node_pool;
+	int m_pool_net;
+
 	bool manageList(TrMapList ** list, bool del, const QString & name);
 	bool createNodeInOut();
 
@@ -107,8 +127,23 @@ public:
 
 	void appendLink(TrMapLink * link);
 
+	// merges links at nodes with one way through (1 in, 1 out or 2 in, 2 out)
+	// and the same attributes, call it before 'init', returns the removed nodes
+	int mergeChains();
+
 	bool addNode(uint64_t id);
 
+	void setNodePool(const QSharedPointer<TrMapNodePool> & pool, int pool_net);
+
+	const TrMapNodePool * getNodePool() const;
+
+	// node objects of both nets at the shared nodes of the pool, the
+	// same index in 'nodes' and 'other_nodes'
+	int joinNodes(TrMapNet & other, QVector<TrMapNode *> & nodes, QVector<TrMapNode *> & other_nodes);
+
+	// sets TR_NODE_IS_SHARED at the joined nodes of both nets
+	int markSharedNodes(TrMapNet & other);
+
 	virtual bool init(const TrZoomMap & zoom_ref, uint64_t ctrl = 0, TrGeoObject * base = nullptr);
 
 	virtual void draw(const TrZoomMap & zoom_ref, QPainter * p, unsigned char mode);
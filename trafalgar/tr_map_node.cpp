@@ -226,10 +226,7 @@ void TrMapNode::resetIoOut()
 {
 	m_vec_in.clear();
 	m_vec_out.clear();
-	if(m_dir_flags & TR_NODE_IS_SHADOW)
-		m_dir_flags = (TR_NODE_IS_SHADOW | TR_NODE_DIR_EMTY);
-	else
-		m_dir_flags = TR_NODE_DIR_EMTY;
+	m_dir_flags = (m_dir_flags & (TR_NODE_IS_SHADOW | TR_NODE_IS_SHARED)) | TR_NODE_DIR_EMTY;
 	//TR_INF << HEX << m_dir_flags;
 }
 
@@ -237,10 +234,7 @@ bool TrMapNode::setDirFlags()
 {
 	if((m_vec_in.size() == 0) && (m_vec_out.size() == 0))
 	{
-		if(m_dir_flags & TR_NODE_IS_SHADOW)
-			m_dir_flags = (TR_NODE_IS_SHADOW | TR_NODE_DIR_EMTY);
-		else
-			m_dir_flags = TR_NODE_DIR_EMTY;
+		m_dir_flags = (m_dir_flags & (TR_NODE_IS_SHADOW | TR_NODE_IS_SHARED)) | TR_NODE_DIR_EMTY;
 		return false;
 	}
 	m_dir_flags &= ~(TR_LINK_DIR_ONEWAY);
@@ -902,6 +896,19 @@ void TrMapNode::setShadowNode(TrMapNode * node)
 	}
 }
 
+void TrMapNode::setSharedNode(bool shared)
+{
+	if(shared)
+		m_dir_flags |= TR_NODE_IS_SHARED;
+	else
+		m_dir_flags &= ~TR_NODE_IS_SHARED;
+}
+
+bool TrMapNode::isSharedNode() const
+{
+	return (m_dir_flags & TR_NODE_IS_SHARED) != 0;
+}
+
 bool TrMapNode::markDivider(TrMapList & list, TrGeoObject * obj)
 {
 	if(m_shadow == nullptr)
@@ -1044,7 +1051,10 @@ void TrMapNode::draw(const TrZoomMap & zoom_ref, QPainter * p, unsigned char mod
 	// TODO check crash
 	p->setPen(*getActivePen());
 	// TODO: remove hardcoded color
-	p->setBrush(QBrush(QColor(220,174,192)));
+	if(m_dir_flags & TR_NODE_IS_SHARED)
+		p->setBrush(QBrush(QColor(120,120,220)));
+	else
+		p->setBrush(QBrush(QColor(220,174,192)));
 
 	/* test code
 	p->setPen(QPen(QColor(0,0,200)));
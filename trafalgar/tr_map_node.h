@@ -51,6 +51,8 @@
 
 // used in m_dir_flags
 #define TR_NODE_IS_SHADOW 0x80
+// the node is in an other net too (level crossing...), see TrMapNet::markSharedNodes
+#define TR_NODE_IS_SHARED 0x40
 
 #define TR_NODE_IN  true
 #define TR_NODE_OUT false
@@ -150,6 +152,10 @@ public:
 
 	void setShadowNode(TrMapNode * node);
 
+	void setSharedNode(bool shared);
+
+	bool isSharedNode() const;
+
 	bool markDivider(TrMapList & list, TrGeoObject * obj);
 
 	int getIndexFromObj(const TrGeoObject * obj, bool dir);
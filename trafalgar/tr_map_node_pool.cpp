@@ -0,0 +1,121 @@
+/******************************************************************
+ *
+ * @short	node pool shared by the nets of a map
+ *
+ * project:	Trafalgar lib
+ *
+ * class:	TrMapNodePool
+ * superclass:	---
+ * modul:	tr_map_node_pool.cpp
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU trafalgar package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the trafalgar package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+#include "tr_map_node_pool.h"
+
+#include "tr_defs.h"
+
+#include <algorithm>
+
+TrMapNodePool::TrMapNodePool()
+{
+}
+
+void TrMapNodePool::reserve(int n_node)
+{
+	m_ids.reserve(n_node);
+	m_pts.reserve(n_node);
+	m_nets.reserve(n_node);
+}
+
+void TrMapNodePool::clear()
+{
+	m_ids.clear();
+	m_pts.clear();
+	m_nets.clear();
+}
+
+int TrMapNodePool::size() const
+{
+	return m_ids.size();
+}
+
+int TrMapNodePool::appendNode(uint64_t id, const TrPoint32 & pt, uint8_t nets)
+{
+	if((!m_ids.isEmpty()) && (id <= m_ids.last()))
+	{
+		TR_WRN << "id not sorted" << id << m_ids.last();
+		return -1;
+	}
+	m_ids.append(id);
+	m_pts.append(pt);
+	m_nets.append(nets);
+	return m_ids.size() - 1;
+}
+
+int TrMapNodePool::find(uint64_t id) const
+{
+	QVector<uint64_t>::const_iterator it = std::lower_bound(m_ids.constBegin(), m_ids.constEnd(), id);
+	if((it == m_ids.constEnd()) || (*it != id))
+		return -1;
+	return static_cast<int>(it - m_ids.constBegin());
+}
+
+uint64_t TrMapNodePool::getId(int slot) const
+{
+	return m_ids[slot];
+}
+
+TrPoint TrMapNodePool::getPoint(int slot) const
+{
+	TrPoint pt;
+
+	pt.x = m_pts[slot].x/TR_POOL_COOR_DIV;
+	pt.y = m_pts[slot].y/TR_POOL_COOR_DIV;
+	return pt;
+}
+
+uint8_t TrMapNodePool::getNets(int slot) const
+{
+	return m_nets[slot];
+}
+
+QVector<int> TrMapNodePool::join(int net1, int net2) const
+{
+	QVector<int> slots;
+
+	if((net1 < 0) || (net1 >= TR_POOL_MAX_NET) || (net2 < 0) || (net2 >= TR_POOL_MAX_NET))
+		return slots;
+
+	uint8_t mask = static_cast<uint8_t>((1 << net1) | (1 << net2));
+	const uint8_t * nets = m_nets.constData();
+	for(int i = 0; i < m_nets.size(); ++i)
+	{
+		if((nets[i] & mask) == mask)
+			slots.append(i);
+	}
+	return slots;
+}
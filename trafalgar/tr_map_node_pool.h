@@ -0,0 +1,89 @@
+/******************************************************************
+ *
+ * @short	node pool shared by the nets of a map
+ *
+ * project:	Trafalgar lib
+ *
+ * class:	TrMapNodePool
+ * superclass:	---
+ * modul:	tr_map_node_pool.h
+ *
+ * system:	UNIX/LINUX
+ * compiler:	gcc
+ *
+ * beginning:	10.2026
+ *
+ * @author	Schmid Hubert (C)2026
+ *
+ * history:
+ *
+ ******************************************************************/
+
+/* The trafalgar package is free software.  You may redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * The GNU trafalgar package is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with the GNU plotutils package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef TR_MAP_NODE_POOL_H
+#define TR_MAP_NODE_POOL_H
+
+#include <QVector>
+
+#include <stdint.h>
+
+#include "tr_point.h"
+
+// nets of a pool, one bit each in the use mask
+#define TR_POOL_MAX_NET    8
+// TrPoint32 of the pool -> TrPoint (TR_COOR_FACTOR)
+#define TR_POOL_COOR_DIV   100.0
+
+// One entry for each node id of all nets: id, coordinate and the nets
+// using it. The slot of a node is its index, the ids are sorted, so a
+// join of two nets is a scan of the use masks. The links of a node
+// (connectivity) are kept by the TrMapNode object of each net.
+class TrMapNodePool
+{
+private:
+	QVector<uint64_t> m_ids;
+	QVector<TrPoint32> m_pts;
+	// bit n: used by net n
+	QVector<uint8_t> m_nets;
+
+public:
+	TrMapNodePool();
+
+	void reserve(int n_node);
+
+	void clear();
+
+	int size() const;
+
+	// the ids must be appended in ascending order, returns the slot or -1
+	int appendNode(uint64_t id, const TrPoint32 & pt, uint8_t nets);
+
+	// slot of the id, -1 for an unknown id
+	int find(uint64_t id) const;
+
+	uint64_t getId(int slot) const;
+
+	TrPoint getPoint(int slot) const;
+
+	uint8_t getNets(int slot) const;
+
+	// slots used by both nets
+	QVector<int> join(int net1, int net2) const;
+};
+
+#endif // TR_MAP_NODE_POOL_H